@@ -0,0 +1,102 @@
+/*
+Title: AABB-3D
+File Name: AABB.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _AABB_H
+#define _AABB_H
+
+#include "MathIncludes.h"
+#include <cmath>
+
+struct AABB
+{
+	glm::vec3 min;
+	glm::vec3 max;
+
+	AABB(const glm::vec3 &minVal, const glm::vec3 &maxVal)
+	{
+		min = minVal;
+		max = maxVal;
+	}
+	AABB()
+	{
+		min = glm::vec3(0.0f);
+		max = glm::vec3(0.0f);
+	}
+};
+
+// Works out the world space AABB of a local space box after it's been transformed by the given matrix, without transforming all 8 corners. (This is
+// Arvo's method.)
+// Think of the box as a center point plus an extent (half the size) on each axis. The center just gets transformed like any point.
+// Each world axis extent is then the sum of how far each local axis extent reaches along that world axis, which is the absolute value of the
+// matching entry in the rotation/scale part of the matrix times that local extent.
+inline AABB TransformAABB(const AABB& local, const glm::mat4& transformation)
+{
+	glm::vec3 center = (local.min + local.max) * 0.5f;
+	glm::vec3 extent = (local.max - local.min) * 0.5f;
+
+	glm::vec3 worldCenter = glm::vec3(transformation * glm::vec4(center, 1.0f));
+	glm::vec3 worldExtent;
+
+	// Remember that glm matrices are column major, so transformation[column][row].
+	for (int i = 0; i < 3; i++)
+	{
+		worldExtent[i] = fabsf(transformation[0][i]) * extent.x + fabsf(transformation[1][i]) * extent.y + fabsf(transformation[2][i]) * extent.z;
+	}
+
+	return AABB(worldCenter - worldExtent, worldCenter + worldExtent);
+}
+
+struct CalculatorAABB
+{
+	glm::vec4 min;
+	glm::vec4 max;
+
+	CalculatorAABB(const glm::vec4 &minVal, const glm::vec4 &maxVal)
+	{
+		min = minVal;
+		max = maxVal;
+	}
+	CalculatorAABB()
+	{
+		min = glm::vec4(0.0f);
+		max = glm::vec4(0.0f);
+	}
+};
+
+#endif //_AABB_H
@@ -0,0 +1,413 @@
+/*
+Title: AABB-3D
+File Name: AABBStore.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _AABB_STORE_CPP
+#define _AABB_STORE_CPP
+
+#include "AABBStore.h"
+#include <cstring>
+#include <cfloat>
+#include <algorithm>
+
+AABBStore::AABBStore()
+{
+	minX = minY = minZ = nullptr;
+	maxX = maxY = maxZ = nullptr;
+	size = 0;
+	capacity = 0;
+}
+
+AABBStore::~AABBStore()
+{
+	AlignedFree(minX);
+	AlignedFree(minY);
+	AlignedFree(minZ);
+	AlignedFree(maxX);
+	AlignedFree(maxY);
+	AlignedFree(maxZ);
+}
+
+void AABBStore::Grow(int newCapacity)
+{
+	// Always keep the capacity a multiple of 16, so the vector loops can read whole blocks without running off the end.
+	newCapacity = (newCapacity + 15) & ~15;
+
+	float** arrays[6] = { &minX, &minY, &minZ, &maxX, &maxY, &maxZ };
+
+	for (int i = 0; i < 6; i++)
+	{
+		float* newArray = AlignedAlloc(newCapacity);
+
+		if (*arrays[i] != nullptr)
+		{
+			memcpy(newArray, *arrays[i], sizeof(float) * size);
+			AlignedFree(*arrays[i]);
+		}
+
+		*arrays[i] = newArray;
+	}
+
+	int oldSize = size;
+	capacity = newCapacity;
+
+	// Fill everything past the end with empty boxes.
+	for (int i = oldSize; i < capacity; i++)
+	{
+		SetEmpty(i);
+	}
+}
+
+// Makes the box at the given index one that can't overlap anything.
+void AABBStore::SetEmpty(int index)
+{
+	minX[index] = minY[index] = minZ[index] = FLT_MAX;
+	maxX[index] = maxY[index] = maxZ[index] = -FLT_MAX;
+}
+
+void AABBStore::Reserve(int count)
+{
+	if (count > capacity)
+	{
+		Grow(count);
+	}
+}
+
+int AABBStore::Add(const AABB& box)
+{
+	if (size == capacity)
+	{
+		// Double the capacity so that adding n boxes is O(n) overall.
+		Grow(capacity == 0 ? 16 : capacity * 2);
+	}
+
+	Set(size, box);
+	return size++;
+}
+
+void AABBStore::Set(int index, const AABB& box)
+{
+	minX[index] = box.min.x;
+	minY[index] = box.min.y;
+	minZ[index] = box.min.z;
+	maxX[index] = box.max.x;
+	maxY[index] = box.max.y;
+	maxZ[index] = box.max.z;
+}
+
+AABB AABBStore::Get(int index) const
+{
+	return AABB(glm::vec3(minX[index], minY[index], minZ[index]), glm::vec3(maxX[index], maxY[index], maxZ[index]));
+}
+
+void AABBStore::RemoveSwap(int index)
+{
+	int last = size - 1;
+
+	if (index != last)
+	{
+		minX[index] = minX[last];
+		minY[index] = minY[last];
+		minZ[index] = minZ[last];
+		maxX[index] = maxX[last];
+		maxY[index] = maxY[last];
+		maxZ[index] = maxZ[last];
+	}
+
+	// The old last slot is now padding, so it has to be empty again.
+	SetEmpty(last);
+	size--;
+}
+
+void AABBStore::Clear()
+{
+	for (int i = 0; i < size; i++)
+	{
+		SetEmpty(i);
+	}
+
+	size = 0;
+}
+
+unsigned int AABBStore::OverlapMask8(const AABB& query, int block) const
+{
+	int i = block * 8;
+
+	// Same test as TestAABB, just flipped around: two boxes overlap if, on every axis, each one's max is at least the other one's min.
+#if defined(PHYSICS_AVX)
+	__m256 overlap = _mm256_and_ps(
+		_mm256_cmp_ps(_mm256_load_ps(maxX + i), _mm256_set1_ps(query.min.x), _CMP_GE_OQ),
+		_mm256_cmp_ps(_mm256_load_ps(minX + i), _mm256_set1_ps(query.max.x), _CMP_LE_OQ));
+	overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(_mm256_load_ps(maxY + i), _mm256_set1_ps(query.min.y), _CMP_GE_OQ));
+	overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(_mm256_load_ps(minY + i), _mm256_set1_ps(query.max.y), _CMP_LE_OQ));
+	overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(_mm256_load_ps(maxZ + i), _mm256_set1_ps(query.min.z), _CMP_GE_OQ));
+	overlap = _mm256_and_ps(overlap, _mm256_cmp_ps(_mm256_load_ps(minZ + i), _mm256_set1_ps(query.max.z), _CMP_LE_OQ));
+
+	// Movemask packs the top bit of each of the 8 results into the low 8 bits of an int.
+	return (unsigned int)_mm256_movemask_ps(overlap);
+#elif defined(PHYSICS_SSE)
+	__m128 qMinX = _mm_set1_ps(query.min.x);
+	__m128 qMinY = _mm_set1_ps(query.min.y);
+	__m128 qMinZ = _mm_set1_ps(query.min.z);
+	__m128 qMaxX = _mm_set1_ps(query.max.x);
+	__m128 qMaxY = _mm_set1_ps(query.max.y);
+	__m128 qMaxZ = _mm_set1_ps(query.max.z);
+
+	unsigned int mask = 0;
+
+	// SSE registers only hold 4 floats, so do the block in two halves.
+	for (int half = 0; half < 2; half++)
+	{
+		int j = i + half * 4;
+
+		__m128 overlap = _mm_and_ps(_mm_cmpge_ps(_mm_load_ps(maxX + j), qMinX), _mm_cmple_ps(_mm_load_ps(minX + j), qMaxX));
+		overlap = _mm_and_ps(overlap, _mm_cmpge_ps(_mm_load_ps(maxY + j), qMinY));
+		overlap = _mm_and_ps(overlap, _mm_cmple_ps(_mm_load_ps(minY + j), qMaxY));
+		overlap = _mm_and_ps(overlap, _mm_cmpge_ps(_mm_load_ps(maxZ + j), qMinZ));
+		overlap = _mm_and_ps(overlap, _mm_cmple_ps(_mm_load_ps(minZ + j), qMaxZ));
+
+		mask |= (unsigned int)_mm_movemask_ps(overlap) << (half * 4);
+	}
+
+	return mask;
+#else
+	// Plain C++ fallback for CPUs we don't have a vector path for.
+	unsigned int mask = 0;
+
+	for (int k = 0; k < 8; k++)
+	{
+		bool overlap = maxX[i + k] >= query.min.x && minX[i + k] <= query.max.x &&
+			maxY[i + k] >= query.min.y && minY[i + k] <= query.max.y &&
+			maxZ[i + k] >= query.min.z && minZ[i + k] <= query.max.z;
+
+		mask |= (unsigned int)overlap << k;
+	}
+
+	return mask;
+#endif
+}
+
+void AABBStore::OverlapMasks(const AABB& query, unsigned int* masks) const
+{
+	int numBlocks = (size + 7) / 8;
+	int numMasks = (size + 31) / 32;
+
+	for (int w = 0; w < numMasks; w++)
+	{
+		masks[w] = 0;
+	}
+
+	// Four blocks of 8 make up one 32 bit mask.
+	for (int block = 0; block < numBlocks; block++)
+	{
+		masks[block / 4] |= OverlapMask8(query, block) << ((block % 4) * 8);
+	}
+}
+
+unsigned int AABBStore::RayMask8(const PreparedRay& ray, float reach, int block, float* distances) const
+{
+	int i = block * 8;
+
+	// The ray heads the same way for every box, so we can pick which array holds the near plane of each axis once, up front.
+	const float* mins[3] = { minX + i, minY + i, minZ + i };
+	const float* maxs[3] = { maxX + i, maxY + i, maxZ + i };
+	const float* nearPlanes[3];
+	const float* farPlanes[3];
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		bool positive = ray.inverseDirection[axis] >= 0.0f;
+		nearPlanes[axis] = positive ? mins[axis] : maxs[axis];
+		farPlanes[axis] = positive ? maxs[axis] : mins[axis];
+	}
+
+#if defined(PHYSICS_AVX)
+	__m256 tNear = _mm256_setzero_ps();
+	__m256 tFar = _mm256_set1_ps(reach);
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		__m256 origin = _mm256_set1_ps(ray.origin[axis]);
+		__m256 inverse = _mm256_set1_ps(ray.inverseDirection[axis]);
+
+		tNear = _mm256_max_ps(tNear, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(nearPlanes[axis]), origin), inverse));
+		tFar = _mm256_min_ps(tFar, _mm256_mul_ps(_mm256_sub_ps(_mm256_load_ps(farPlanes[axis]), origin), inverse));
+	}
+
+	_mm256_storeu_ps(distances, tNear);
+	return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ));
+#elif defined(PHYSICS_SSE)
+	unsigned int mask = 0;
+
+	// SSE registers only hold 4 floats, so do the block in two halves.
+	for (int half = 0; half < 2; half++)
+	{
+		int j = half * 4;
+
+		__m128 tNear = _mm_setzero_ps();
+		__m128 tFar = _mm_set1_ps(reach);
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			__m128 origin = _mm_set1_ps(ray.origin[axis]);
+			__m128 inverse = _mm_set1_ps(ray.inverseDirection[axis]);
+
+			tNear = _mm_max_ps(tNear, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(nearPlanes[axis] + j), origin), inverse));
+			tFar = _mm_min_ps(tFar, _mm_mul_ps(_mm_sub_ps(_mm_load_ps(farPlanes[axis] + j), origin), inverse));
+		}
+
+		_mm_storeu_ps(distances + j, tNear);
+		mask |= (unsigned int)_mm_movemask_ps(_mm_cmple_ps(tNear, tFar)) << j;
+	}
+
+	return mask;
+#else
+	// Plain C++ fallback for CPUs we don't have a vector path for.
+	unsigned int mask = 0;
+
+	for (int k = 0; k < 8; k++)
+	{
+		float tNear = 0.0f;
+		float tFar = reach;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			tNear = std::max(tNear, (nearPlanes[axis][k] - ray.origin[axis]) * ray.inverseDirection[axis]);
+			tFar = std::min(tFar, (farPlanes[axis][k] - ray.origin[axis]) * ray.inverseDirection[axis]);
+		}
+
+		distances[k] = tNear;
+		mask |= (unsigned int)(tNear <= tFar) << k;
+	}
+
+	return mask;
+#endif
+}
+
+unsigned int AABBStore::FrustumMask8(const Frustum& frustum, int block) const
+{
+	int i = block * 8;
+
+	// For each plane, the corner of every box that's furthest along the normal is on the same side (max on the axes where the normal is positive, min
+	// where it's negative), so we can pick the arrays once per plane instead of once per box.
+	const float* mins[3] = { minX + i, minY + i, minZ + i };
+	const float* maxs[3] = { maxX + i, maxY + i, maxZ + i };
+
+#if defined(PHYSICS_AVX)
+	__m256 visible = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+	for (int p = 0; p < 6; p++)
+	{
+		const glm::vec4& plane = frustum.planes[p];
+
+		__m256 x = _mm256_load_ps(plane.x >= 0.0f ? maxs[0] : mins[0]);
+		__m256 y = _mm256_load_ps(plane.y >= 0.0f ? maxs[1] : mins[1]);
+		__m256 z = _mm256_load_ps(plane.z >= 0.0f ? maxs[2] : mins[2]);
+
+		__m256 distance = _mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(plane.x), x), _mm256_mul_ps(_mm256_set1_ps(plane.y), y));
+		distance = _mm256_add_ps(distance, _mm256_mul_ps(_mm256_set1_ps(plane.z), z));
+		distance = _mm256_add_ps(distance, _mm256_set1_ps(plane.w));
+
+		visible = _mm256_and_ps(visible, _mm256_cmp_ps(distance, _mm256_setzero_ps(), _CMP_GE_OQ));
+	}
+
+	return (unsigned int)_mm256_movemask_ps(visible);
+#elif defined(PHYSICS_SSE)
+	unsigned int mask = 0;
+
+	// SSE registers only hold 4 floats, so do the block in two halves.
+	for (int half = 0; half < 2; half++)
+	{
+		int j = half * 4;
+		__m128 visible = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+		for (int p = 0; p < 6; p++)
+		{
+			const glm::vec4& plane = frustum.planes[p];
+
+			__m128 x = _mm_load_ps((plane.x >= 0.0f ? maxs[0] : mins[0]) + j);
+			__m128 y = _mm_load_ps((plane.y >= 0.0f ? maxs[1] : mins[1]) + j);
+			__m128 z = _mm_load_ps((plane.z >= 0.0f ? maxs[2] : mins[2]) + j);
+
+			__m128 distance = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), x), _mm_mul_ps(_mm_set1_ps(plane.y), y));
+			distance = _mm_add_ps(distance, _mm_mul_ps(_mm_set1_ps(plane.z), z));
+			distance = _mm_add_ps(distance, _mm_set1_ps(plane.w));
+
+			visible = _mm_and_ps(visible, _mm_cmpge_ps(distance, _mm_setzero_ps()));
+		}
+
+		mask |= (unsigned int)_mm_movemask_ps(visible) << j;
+	}
+
+	return mask;
+#else
+	// Plain C++ fallback for CPUs we don't have a vector path for.
+	unsigned int mask = 0;
+
+	for (int k = 0; k < 8; k++)
+	{
+		AABB box(glm::vec3(mins[0][k], mins[1][k], mins[2][k]), glm::vec3(maxs[0][k], maxs[1][k], maxs[2][k]));
+		mask |= (unsigned int)frustum.Intersects(box) << k;
+	}
+
+	return mask;
+#endif
+}
+
+void AABBStore::Query(const AABB& query, std::vector<int>& hits) const
+{
+	hits.clear();
+
+	int numBlocks = (size + 7) / 8;
+
+	for (int block = 0; block < numBlocks; block++)
+	{
+		unsigned int mask = OverlapMask8(query, block);
+
+		// Walk through the set bits.
+		for (int k = 0; mask != 0; k++, mask >>= 1)
+		{
+			if (mask & 1)
+			{
+				hits.push_back(block * 8 + k);
+			}
+		}
+	}
+}
+
+#endif // _AABB_STORE_CPP
@@ -0,0 +1,117 @@
+/*
+Title: AABB-3D
+File Name: AABBStore.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _AABB_STORE_H
+#define _AABB_STORE_H
+
+#include "AABB.h"
+#include "RayCast.h"
+#include "Frustum.h"
+#include "Simd.h"
+#include <vector>
+
+// Stores a set of AABBs as a structure of arrays (SoA): one array of every box's min x, one of every box's min y, and so on.
+// The AABB struct itself is an array of structs (AoS) layout, which is fine for one box at a time, but when we want to test one box against lots of others it
+// means the values we want are scattered all over memory. Laid out like this, eight min x values are sitting right next to each other, so we can load all of
+// them with one instruction and compare them all at once.
+// The arrays are 32-byte aligned and padded to a multiple of 16 boxes. Padding boxes are "empty" (min is huge, max is tiny), so they never overlap anything,
+// which means the test loops never have to worry about a leftover partial block.
+class AABBStore
+{
+	float* minX;
+	float* minY;
+	float* minZ;
+	float* maxX;
+	float* maxY;
+	float* maxZ;
+
+	int size;
+	int capacity;
+
+	void Grow(int newCapacity);
+	void SetEmpty(int index);
+
+	// Copying would mean two stores freeing the same arrays.
+	AABBStore(const AABBStore&);
+	AABBStore& operator=(const AABBStore&);
+
+public:
+	AABBStore();
+	~AABBStore();
+
+	// Adds a box to the end of the store and returns its index.
+	int Add(const AABB& box);
+
+	// Overwrites the box at the given index.
+	void Set(int index, const AABB& box);
+
+	// Returns the box at the given index as a regular AABB.
+	AABB Get(int index) const;
+
+	// Removes the box at the given index by moving the last box into its place (so the order is not kept, but it's O(1)).
+	void RemoveSwap(int index);
+
+	void Clear();
+	void Reserve(int count);
+
+	int Size() const
+	{
+		return size;
+	}
+
+	// Tests the query box against the 8 boxes starting at index block * 8, and returns a bitmask where bit i is set if box block * 8 + i overlaps the query.
+	unsigned int OverlapMask8(const AABB& query, int block) const;
+
+	// Tests the query box against every box in the store. Bit i of masks[w] is set if box w * 32 + i overlaps the query.
+	// masks needs room for (Size() + 31) / 32 values.
+	void OverlapMasks(const AABB& query, unsigned int* masks) const;
+
+	// Clears hits and fills it with the index of every box that overlaps the query box.
+	void Query(const AABB& query, std::vector<int>& hits) const;
+
+	// Slab tests the ray (looking no further than reach) against the 8 boxes starting at index block * 8. Returns a bitmask where bit i is set if the ray
+	// hits box block * 8 + i, and fills distances with where the ray enters each box. Gives exactly the same answers as RayTestAABB.
+	unsigned int RayMask8(const PreparedRay& ray, float reach, int block, float* distances) const;
+
+	// Tests the 8 boxes starting at index block * 8 against the frustum, and returns a bitmask where bit i is set if box block * 8 + i might be visible.
+	// Gives exactly the same answers as Frustum::Intersects. (Padding boxes are never visible.)
+	unsigned int FrustumMask8(const Frustum& frustum, int block) const;
+};
+
+#endif //_AABB_STORE_H
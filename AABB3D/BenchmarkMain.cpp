@@ -0,0 +1,885 @@
+/*
+Title: AABB-3D
+File Name: BenchmarkMain.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+// This is the benchmark program. It times the parts of the physics that matter the most for performance, and writes the results out in a form that a
+// script can read, so that results from two builds can be compared to catch anything that got slower.
+// There are two kinds of benchmarks:
+// - Micro benchmarks time one small operation (like a single TestAABB) many times over, and report how long each one took in nanoseconds.
+// - Macro benchmarks run whole scenes of cubes through the same update as the windowed demo (rotate everything, then step the world), and report how long
+//   each step took.
+// Like the headless program, this needs no window and no OpenGL.
+// Before timing anything, it checks that every broadphase still finds the right pairs (a fast wrong answer is no use), and stops with an error if one doesn't.
+// Usage: AABB3DBenchmark [--json file] [--csv file] [--quick]
+// --quick skips the biggest meshes and scenes, for a fast sanity check.
+
+#include "Physics.h"
+#include "Scene.h"
+#include "QuantizedAABB.h"
+#include "SweepAndPrune.h"
+#include "DynamicAABBTree.h"
+#include "SpatialHashGrid.h"
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <functional>
+#include <cstring>
+#include <cmath>
+
+typedef std::chrono::steady_clock Clock;
+
+// The results of one benchmark. Every time is in nanoseconds per operation. (For the macro benchmarks, one operation is one physics step.)
+struct BenchmarkResult
+{
+	std::string suite;
+	std::string name;
+	int size;
+	long long operations;
+	double mean;
+	double p50;
+	double p99;
+};
+
+std::vector<BenchmarkResult> results;
+
+// Benchmarks write their results into this, so that the compiler can't decide the work is unused and optimize it away.
+volatile float sink = 0.0f;
+
+// Finds the value that the given fraction of samples are at or below.
+double Percentile(std::vector<double> samples, double fraction)
+{
+	size_t index = (size_t)(fraction * (samples.size() - 1) + 0.5);
+	std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+	return samples[index];
+}
+
+void AddResult(const std::string& suite, const std::string& name, int size, long long operations, const std::vector<double>& samples)
+{
+	BenchmarkResult result;
+	result.suite = suite;
+	result.name = name;
+	result.size = size;
+	result.operations = operations;
+
+	double total = 0.0;
+	for (size_t i = 0; i < samples.size(); i++)
+	{
+		total += samples[i];
+	}
+
+	result.mean = total / samples.size();
+	result.p50 = Percentile(samples, 0.5);
+	result.p99 = Percentile(samples, 0.99);
+
+	results.push_back(result);
+
+	std::cout << std::left << std::setw(7) << suite << std::setw(24) << name << std::right << std::setw(9) << size
+		<< std::fixed << std::setprecision(1)
+		<< "   p50 " << std::setw(14) << result.p50 << " ns"
+		<< "   p99 " << std::setw(14) << result.p99 << " ns" << std::endl;
+}
+
+// Runs a micro benchmark. run(n) should do the operation n times.
+// First the number of operations per sample is doubled until one sample takes long enough to time accurately, and then that many operations are timed
+// over and over. Each sample gives one "nanoseconds per operation" value, and the p50/p99 are taken across the samples.
+// opsPerCall is for when one call to run(1) does more than one operation (like adding a whole mesh worth of vertices).
+void Micro(const std::string& name, int size, std::function<void(int)> run, long long opsPerCall = 1)
+{
+	const double minSampleSeconds = 0.01;
+	const int numSamples = 30;
+
+	// Warm up the caches, and work out how many operations one sample needs.
+	int n = 1;
+	while (true)
+	{
+		Clock::time_point start = Clock::now();
+		run(n);
+		double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+		if (seconds >= minSampleSeconds || n >= (1 << 30))
+		{
+			break;
+		}
+
+		n *= 2;
+	}
+
+	std::vector<double> samples;
+	for (int i = 0; i < numSamples; i++)
+	{
+		Clock::time_point start = Clock::now();
+		run(n);
+		double nanoseconds = std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+
+		samples.push_back(nanoseconds / ((double)n * opsPerCall));
+	}
+
+	AddResult("micro", name, size, (long long)n * numSamples * opsPerCall, samples);
+}
+
+// Builds a model with count vertices scattered through a unit sphere, which stands in for a real mesh.
+Model* CreatePointCloud(int count, unsigned int seed)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+
+	std::vector<VertexFormat> vertices;
+	vertices.reserve(count);
+
+	while ((int)vertices.size() < count)
+	{
+		glm::vec3 position;
+		position.x = coordinate(random);
+		position.y = coordinate(random);
+		position.z = coordinate(random);
+
+		if (glm::dot(position, position) <= 1.0f)
+		{
+			vertices.push_back(VertexFormat(position, glm::vec4(1.0f)));
+		}
+	}
+
+	Model* model = new Model();
+	model->AddVertices(&vertices[0], count);
+	return model;
+}
+
+// Makes count pairs of random boxes. If overlapping is true every pair overlaps, otherwise none of them do.
+void CreateBoxPairs(int count, bool overlapping, unsigned int seed, std::vector<AABB>& a, std::vector<AABB>& b)
+{
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> position(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> size(0.1f, 1.0f);
+
+	while ((int)a.size() < count)
+	{
+		glm::vec3 center;
+		center.x = position(random);
+		center.y = position(random);
+		center.z = position(random);
+
+		glm::vec3 extentA(size(random), size(random), size(random));
+		glm::vec3 extentB(size(random), size(random), size(random));
+
+		// Move the second box a bit away from the first along every axis. It overlaps as long as it's closer than the two extents put together.
+		glm::vec3 offset;
+		offset.x = (extentA.x + extentB.x) * (overlapping ? 0.5f : 1.5f);
+		offset.y = (extentA.y + extentB.y) * 0.5f;
+		offset.z = (extentA.z + extentB.z) * 0.5f;
+
+		AABB boxA(center - extentA, center + extentA);
+		AABB boxB(center + offset - extentB, center + offset + extentB);
+
+		if (TestAABB(boxA, boxB) == overlapping)
+		{
+			a.push_back(boxA);
+			b.push_back(boxB);
+		}
+	}
+}
+
+// Checks that every broadphase finds exactly the overlapping pairs that testing every box against every other box does, whether FindPairs runs on one
+// thread, is split across a job system with several workers, or is handed a job system with no workers at all (where ParallelFor runs every chunk in a
+// single call). The job systems take turns on the same broadphase, with some of the boxes moved in between, so a list left over from an earlier call
+// would show up as a wrong or repeated pair. Prints what went wrong and returns false if anything did.
+bool CheckBroadphases()
+{
+	const int count = 5000;
+	const int rounds = 6;
+
+	std::mt19937 random(9);
+	std::uniform_real_distribution<float> coordinate(-10.0f, 10.0f);
+	std::uniform_real_distribution<float> halfSize(0.05f, 0.5f);
+
+	// A couple of much bigger boxes too, so the spatial hash grid has some oversized ones.
+	auto randomBox = [&random, &coordinate, &halfSize](int i)
+	{
+		glm::vec3 center(coordinate(random), coordinate(random), coordinate(random));
+		glm::vec3 half(halfSize(random) * (i % 1000 == 0 ? 20.0f : 1.0f));
+		return AABB(center - half, center + half);
+	};
+
+	JobSystem manyWorkers(4);
+	JobSystem noWorkers(1);
+	JobSystem* systems[] = { &manyWorkers, &noWorkers, nullptr };
+	const char* systemNames[] = { "4 threads", "1 thread", "no job system" };
+	const char* names[] = { "SweepAndPrune", "DynamicAABBTree", "SpatialHashGrid" };
+
+	bool passed = true;
+
+	for (int b = 0; b < 3; b++)
+	{
+		Broadphase* broadphase;
+		if (b == 0)
+		{
+			broadphase = new SweepAndPrune();
+		}
+		else if (b == 1)
+		{
+			broadphase = new DynamicAABBTree();
+		}
+		else
+		{
+			broadphase = new SpatialHashGrid();
+		}
+
+		// Keep track of which box each proxy ID belongs to, since not every broadphase hands out IDs in order.
+		std::vector<AABB> boxes;
+		std::vector<int> proxies;
+		std::vector<int> boxOfProxy;
+
+		for (int i = 0; i < count; i++)
+		{
+			boxes.push_back(randomBox(i));
+			proxies.push_back(broadphase->CreateProxy(boxes[i], nullptr));
+
+			if ((int)boxOfProxy.size() <= proxies[i])
+			{
+				boxOfProxy.resize(proxies[i] + 1, -1);
+			}
+			boxOfProxy[proxies[i]] = i;
+		}
+
+		std::vector<BroadphasePair> pairs;
+		std::vector<std::pair<int, int> > found;
+		std::vector<std::pair<int, int> > expected;
+
+		for (int round = 0; round < rounds; round++)
+		{
+			// Move every other box (a different half each round).
+			if (round > 0)
+			{
+				for (int i = round % 2; i < count; i += 2)
+				{
+					boxes[i] = randomBox(i);
+					broadphase->MoveProxy(proxies[i], boxes[i]);
+				}
+			}
+
+			int s = round % 3;
+			broadphase->FindPairs(pairs, systems[s]);
+
+			// Every broadphase tests the real boxes before reporting a pair, so the pairs have to match the expected ones exactly, each coming up once.
+			found.clear();
+			for (size_t i = 0; i < pairs.size(); i++)
+			{
+				int a = boxOfProxy[pairs[i].proxyA];
+				int c = boxOfProxy[pairs[i].proxyB];
+
+				found.push_back(std::make_pair(std::min(a, c), std::max(a, c)));
+			}
+			std::sort(found.begin(), found.end());
+
+			expected.clear();
+			for (int i = 0; i < count; i++)
+			{
+				for (int j = i + 1; j < count; j++)
+				{
+					if (TestAABB(boxes[i], boxes[j]))
+					{
+						expected.push_back(std::make_pair(i, j));
+					}
+				}
+			}
+
+			if (found != expected)
+			{
+				std::cout << "FAILED: " << names[b] << " with " << systemNames[s] << " found " << found.size() << " pairs, expected " << expected.size()
+					<< std::endl;
+				passed = false;
+			}
+		}
+
+		delete broadphase;
+	}
+
+	return passed;
+}
+
+void RunMicroBenchmarks(bool quick)
+{
+	// TestAABB, with pairs that all hit, pairs that all miss, and a random mix of the two (which is the hardest for the branch predictor).
+	{
+		const int count = 4096;
+		std::vector<AABB> hitA, hitB, missA, missB, mixedA, mixedB;
+
+		CreateBoxPairs(count, true, 1, hitA, hitB);
+		CreateBoxPairs(count, false, 2, missA, missB);
+
+		std::mt19937 random(3);
+		for (int i = 0; i < count; i++)
+		{
+			bool hit = (random() & 1) != 0;
+			mixedA.push_back(hit ? hitA[i] : missA[i]);
+			mixedB.push_back(hit ? hitB[i] : missB[i]);
+		}
+
+		const char* names[] = { "TestAABB_Hit", "TestAABB_Miss", "TestAABB_Mixed" };
+		std::vector<AABB>* listsA[] = { &hitA, &missA, &mixedA };
+		std::vector<AABB>* listsB[] = { &hitB, &missB, &mixedB };
+
+		for (int list = 0; list < 3; list++)
+		{
+			const AABB* a = &(*listsA[list])[0];
+			const AABB* b = &(*listsB[list])[0];
+
+			Micro(names[list], count, [a, b](int n)
+			{
+				int hits = 0;
+				for (int i = 0; i < n; i++)
+				{
+					hits += TestAABB(a[i & (count - 1)], b[i & (count - 1)]) ? 1 : 0;
+				}
+				sink = sink + (float)hits;
+			});
+		}
+	}
+
+	// Testing one box against a big list of boxes, which is mostly limited by how fast the boxes can be pulled in from memory. This is done with the
+	// regular boxes, and with quantized boxes (only testing the real boxes of the ones that pass). Reported per box tested.
+	{
+		int count = quick ? 100000 : 1000000;
+		std::vector<AABB> boxes;
+		std::vector<AABB> unused;
+		CreateBoxPairs(count / 2, true, 4, boxes, unused);
+		boxes.insert(boxes.end(), unused.begin(), unused.end());
+
+		AABBQuantizer quantizer(AABB(glm::vec3(-12.0f), glm::vec3(12.0f)));
+		std::vector<QuantizedAABB> quantized(boxes.size());
+		for (size_t i = 0; i < boxes.size(); i++)
+		{
+			quantized[i] = quantizer.Quantize(boxes[i]);
+		}
+
+		AABB query(glm::vec3(-1.0f), glm::vec3(1.0f));
+		QuantizedAABB quantizedQuery = quantizer.Quantize(query);
+		const AABB* b = &boxes[0];
+		const QuantizedAABB* q = &quantized[0];
+		int numBoxes = (int)boxes.size();
+
+		Micro("Scan_AABB", numBoxes, [b, query, numBoxes](int n)
+		{
+			int hits = 0;
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = 0; j < numBoxes; j++)
+				{
+					hits += TestAABB(query, b[j]) ? 1 : 0;
+				}
+			}
+			sink = sink + (float)hits;
+		}, numBoxes);
+
+		Micro("Scan_QuantizedAABB", numBoxes, [b, q, query, quantizedQuery, numBoxes](int n)
+		{
+			int hits = 0;
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = 0; j < numBoxes; j++)
+				{
+					hits += (TestQuantizedAABB(quantizedQuery, q[j]) && TestAABB(query, b[j])) ? 1 : 0;
+				}
+			}
+			sink = sink + (float)hits;
+		}, numBoxes);
+	}
+
+	// CalculateAABB, both the fast way (from the model's local box) and the tight way (transforming every vertex), over meshes of different sizes.
+	{
+		int sizes[] = { 8, 64, 1000, 10000, 100000, 1000000 };
+		int numSizes = quick ? 4 : 6;
+
+		for (int s = 0; s < numSizes; s++)
+		{
+			Model* model = CreatePointCloud(sizes[s], 4);
+			GameObject object(model);
+			object.SetPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+			object.SetRotation(glm::vec3(0.3f, 0.5f, 0.7f));
+			object.SetScale(glm::vec3(0.5f, 1.0f, 2.0f));
+
+			GameObject* o = &object;
+
+			object.SetTightAABB(false);
+			Micro("CalculateAABB", sizes[s], [o](int n)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					o->CalculateAABB();
+				}
+				sink = sink + o->GetAABB().max.x;
+			});
+
+			object.SetTightAABB(true);
+			Micro("CalculateAABB_Tight", sizes[s], [o](int n)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					o->CalculateAABB();
+				}
+				sink = sink + o->GetAABB().max.x;
+			});
+
+			delete model;
+		}
+	}
+
+	// CalculateMatrices, which builds the transformation matrix from the translation, rotation and scale.
+	{
+		Model* model = CreateCubeModel();
+		GameObject object(model);
+		object.SetPosition(glm::vec3(1.0f, 2.0f, 3.0f));
+		object.SetRotation(glm::vec3(0.3f, 0.5f, 0.7f));
+		object.SetScale(glm::vec3(0.5f, 1.0f, 2.0f));
+
+		GameObject* o = &object;
+
+		Micro("CalculateMatrices", 1, [o](int n)
+		{
+			for (int i = 0; i < n; i++)
+			{
+				o->CalculateMatrices();
+			}
+			sink = sink + (*o->GetTransform())[3][0];
+		});
+
+		delete model;
+	}
+
+	// Creating and destroying GameObjects, like spawning and despawning projectiles. Every operation here is one create plus one destroy.
+	// This is done both with new/delete and with a GameObjectPool, with a batch of count objects alive at once, destroyed in a shuffled order.
+	{
+		int count = 1024;
+		Model* model = CreateCubeModel();
+
+		std::vector<int> order(count);
+		for (int i = 0; i < count; i++)
+		{
+			order[i] = i;
+		}
+		std::shuffle(order.begin(), order.end(), std::mt19937(5));
+
+		const int* shuffled = &order[0];
+
+		Micro("GameObject_NewDelete", count, [model, count, shuffled](int n)
+		{
+			std::vector<GameObject*> objects(count);
+
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = 0; j < count; j++)
+				{
+					objects[j] = new GameObject(model);
+				}
+				for (int j = 0; j < count; j++)
+				{
+					delete objects[shuffled[j]];
+				}
+			}
+			sink = sink + 1.0f;
+		}, count);
+
+		GameObjectPool pool;
+		GameObjectPool* p = &pool;
+
+		Micro("GameObjectPool", count, [p, model, count, shuffled](int n)
+		{
+			std::vector<GameObjectHandle> handles(count);
+
+			for (int i = 0; i < n; i++)
+			{
+				for (int j = 0; j < count; j++)
+				{
+					handles[j] = p->Create(model);
+				}
+				for (int j = 0; j < count; j++)
+				{
+					p->Destroy(handles[shuffled[j]]);
+				}
+			}
+			sink = sink + 1.0f;
+		}, count);
+
+		delete model;
+	}
+
+	// AddVertex, building up a whole model one vertex at a time. This is reported per vertex, so it should stay flat as the model gets bigger.
+	{
+		int sizes[] = { 1000, 100000, 1000000 };
+		int numSizes = quick ? 2 : 3;
+
+		for (int s = 0; s < numSizes; s++)
+		{
+			int count = sizes[s];
+
+			Micro("AddVertex", count, [count](int n)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					Model model;
+					VertexFormat vertex(glm::vec3(0.0f), glm::vec4(1.0f));
+
+					for (int v = 0; v < count; v++)
+					{
+						vertex.position.x = (float)v;
+						model.AddVertex(&vertex);
+					}
+
+					sink = sink + (float)model.NumVertices();
+				}
+			}, count);
+		}
+	}
+
+	// Casting a batch of rays (for the closest hit of each) through a scene of cubes, with each broadphase. This is reported per ray.
+	{
+		int count = quick ? 1000 : 10000;
+		const char* names[] = { "RayCast_SweepAndPrune", "RayCast_DynamicAABBTree", "RayCast_SpatialHashGrid" };
+
+		// Rays from random points in the scene, in random directions, each one about as long as the scene is wide.
+		std::mt19937 random(5);
+		std::uniform_real_distribution<float> coordinate(-1.0f, 1.0f);
+		float halfExtent = 0.5f * cbrtf((float)count);
+
+		const int numRays = 1024;
+		std::vector<Ray> rays;
+		std::vector<RayHit> hits(numRays);
+
+		for (int i = 0; i < numRays; i++)
+		{
+			glm::vec3 origin, direction;
+			origin.x = coordinate(random) * halfExtent;
+			origin.y = coordinate(random) * halfExtent;
+			origin.z = coordinate(random) * halfExtent;
+			direction.x = coordinate(random);
+			direction.y = coordinate(random);
+			direction.z = coordinate(random);
+
+			rays.push_back(Ray(origin, glm::normalize(direction), 2.0f * halfExtent));
+		}
+
+		for (int b = 0; b < 3; b++)
+		{
+			Model* cube = CreateCubeModel();
+			PhysicsWorld world;
+			GameObjectPool pool;
+			std::vector<GameObjectHandle> objects;
+
+			if (b == 1)
+			{
+				world.SetBroadphase(new DynamicAABBTree());
+			}
+			else if (b == 2)
+			{
+				world.SetBroadphase(new SpatialHashGrid());
+			}
+
+			SpawnCubes(world, pool, cube, count, 1234, 0.9f, objects);
+
+			// Step a few times, so the broadphase is built.
+			for (int i = 0; i < 10; i++)
+			{
+				world.Step(0.012f);
+			}
+
+			PhysicsWorld* w = &world;
+			Ray* r = &rays[0];
+			RayHit* h = &hits[0];
+
+			Micro(names[b], count, [w, r, h, numRays](int n)
+			{
+				for (int i = 0; i < n; i++)
+				{
+					w->RayCast(r, numRays, h);
+				}
+				sink = sink + h[0].distance;
+			}, numRays);
+
+			world.Clear();
+			pool.Clear();
+
+			delete cube;
+		}
+	}
+}
+
+// The same thing update() does in the windowed demo: rotate every object, then step the world.
+void UpdateScene(PhysicsWorld& world, float dt)
+{
+	std::vector<GameObject*>& objects = world.GetObjects();
+
+	ParallelFor(world.GetJobSystem(), (int)objects.size(), 512, [&objects](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			objects[i]->Rotate(glm::vec3(glm::radians(1.0f), glm::radians(1.0f), glm::radians(0.0f)));
+		}
+	});
+
+	world.Step(dt);
+}
+
+void RunMacroBenchmarks(bool quick)
+{
+	int sizes[] = { 1000, 10000, 100000 };
+	int numSizes = quick ? 2 : 3;
+
+	// Every scene is run twice: once all on one thread ("Step"), and once with the per-object phases spread over a job system ("Step_Jobs").
+	JobSystem jobs;
+	JobSystem* configs[] = { nullptr, &jobs };
+	const char* names[] = { "Step", "Step_Jobs" };
+	const char* firstNames[] = { "FirstStep", "FirstStep_Jobs" };
+
+	for (int s = 0; s < numSizes; s++)
+	{
+		for (int c = 0; c < 2; c++)
+		{
+			Model* cube = CreateCubeModel();
+			PhysicsWorld world;
+			GameObjectPool pool;
+			std::vector<GameObjectHandle> objects;
+
+			SpawnCubes(world, pool, cube, sizes[s], 1234, 0.9f, objects);
+			world.SetJobSystem(configs[c]);
+
+			// The very first step is timed on its own, since it has to sort everything from scratch (which is what any big spawn costs too). It's only one
+			// sample, so the p50 and p99 are both just that step.
+			Clock::time_point firstStart = Clock::now();
+			UpdateScene(world, 0.012f);
+			std::vector<double> firstSample(1, std::chrono::duration<double, std::nano>(Clock::now() - firstStart).count());
+			AddResult("macro", firstNames[c], sizes[s], 1, firstSample);
+
+			// Let the broadphase settle in before timing the rest.
+			for (int i = 0; i < 9; i++)
+			{
+				UpdateScene(world, 0.012f);
+			}
+
+			// Time single steps, until we have at least 100 of them and at least two seconds worth.
+			std::vector<double> samples;
+			Clock::time_point begin = Clock::now();
+
+			while (samples.size() < 100 || std::chrono::duration<double>(Clock::now() - begin).count() < 2.0)
+			{
+				Clock::time_point start = Clock::now();
+				UpdateScene(world, 0.012f);
+				samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+			}
+
+			AddResult("macro", names[c], sizes[s], (long long)samples.size(), samples);
+
+			world.Clear();
+			pool.Clear();
+
+			delete cube;
+		}
+	}
+
+	// A scene where nothing is moving or rotating, run with sleeping turned off ("Step_Resting") and on ("Step_Sleeping"). Once everything has fallen asleep
+	// a step should cost very little, no matter how many objects there are.
+	const char* restingNames[] = { "Step_Resting", "Step_Sleeping" };
+
+	for (int s = 0; s < numSizes; s++)
+	{
+		for (int c = 0; c < 2; c++)
+		{
+			Model* cube = CreateCubeModel();
+			PhysicsWorld world;
+			GameObjectPool pool;
+			std::vector<GameObjectHandle> objects;
+
+			SpawnCubes(world, pool, cube, sizes[s], 1234, 0.0f, objects);
+			world.SetSleeping(c == 1);
+
+			// Give everything time to fall asleep first.
+			for (int i = 0; i < 100; i++)
+			{
+				world.Step(0.012f);
+			}
+
+			std::vector<double> samples;
+			Clock::time_point begin = Clock::now();
+
+			while (samples.size() < 100 || std::chrono::duration<double>(Clock::now() - begin).count() < 2.0)
+			{
+				Clock::time_point start = Clock::now();
+				world.Step(0.012f);
+				samples.push_back(std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+			}
+
+			AddResult("macro", restingNames[c], sizes[s], (long long)samples.size(), samples);
+
+			world.Clear();
+			pool.Clear();
+
+			delete cube;
+		}
+	}
+}
+
+// Whether this is a debug build. Results from debug and release builds are nothing alike, so this gets written out with the results.
+const char* BuildType()
+{
+#ifdef NDEBUG
+	return "release";
+#else
+	return "debug";
+#endif
+}
+
+bool WriteJSON(const std::string& fileName)
+{
+	std::ofstream file(fileName, std::ios::out);
+
+	if (!file.good())
+	{
+		return false;
+	}
+
+	file << std::fixed << std::setprecision(3);
+	file << "{" << std::endl;
+	file << "  \"build\": \"" << BuildType() << "\"," << std::endl;
+	file << "  \"unit\": \"ns/op\"," << std::endl;
+	file << "  \"results\": [" << std::endl;
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& r = results[i];
+
+		file << "    {\"suite\": \"" << r.suite << "\", \"name\": \"" << r.name << "\", \"size\": " << r.size << ", \"operations\": " << r.operations
+			<< ", \"mean\": " << r.mean << ", \"p50\": " << r.p50 << ", \"p99\": " << r.p99 << "}";
+
+		if (i + 1 < results.size())
+		{
+			file << ",";
+		}
+
+		file << std::endl;
+	}
+
+	file << "  ]" << std::endl;
+	file << "}" << std::endl;
+
+	return file.good();
+}
+
+bool WriteCSV(const std::string& fileName)
+{
+	std::ofstream file(fileName, std::ios::out);
+
+	if (!file.good())
+	{
+		return false;
+	}
+
+	file << std::fixed << std::setprecision(3);
+	file << "build,suite,name,size,operations,mean_ns,p50_ns,p99_ns" << std::endl;
+
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const BenchmarkResult& r = results[i];
+
+		file << BuildType() << "," << r.suite << "," << r.name << "," << r.size << "," << r.operations << "," << r.mean << "," << r.p50 << "," << r.p99 << std::endl;
+	}
+
+	return file.good();
+}
+
+int main(int argc, char **argv)
+{
+	std::string jsonFile;
+	std::string csvFile;
+	bool quick = false;
+
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--json") == 0 && i + 1 < argc)
+		{
+			jsonFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--csv") == 0 && i + 1 < argc)
+		{
+			csvFile = argv[++i];
+		}
+		else if (strcmp(argv[i], "--quick") == 0)
+		{
+			quick = true;
+		}
+		else
+		{
+			std::cout << "Usage: " << argv[0] << " [--json file] [--csv file] [--quick]" << std::endl;
+			return 1;
+		}
+	}
+
+#ifndef NDEBUG
+	std::cout << "Warning: this is a debug build, so these numbers don't mean much. Use a release build to benchmark." << std::endl;
+#endif
+
+	if (!CheckBroadphases())
+	{
+		return 1;
+	}
+
+	RunMicroBenchmarks(quick);
+	RunMacroBenchmarks(quick);
+
+	if (!jsonFile.empty())
+	{
+		if (!WriteJSON(jsonFile))
+		{
+			std::cout << "Couldn't write " << jsonFile << std::endl;
+			return 1;
+		}
+	}
+
+	if (!csvFile.empty())
+	{
+		if (!WriteCSV(csvFile))
+		{
+			std::cout << "Couldn't write " << csvFile << std::endl;
+			return 1;
+		}
+	}
+
+	return 0;
+}
@@ -0,0 +1,134 @@
+/*
+Title: AABB-3D
+File Name: Broadphase.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _BROADPHASE_H
+#define _BROADPHASE_H
+
+#include "GameObject.h"
+#include "JobSystem.h"
+#include "RayQuery.h"
+#include <vector>
+#include <algorithm>
+
+// A pair of proxies whose AABBs overlap according to a broadphase.
+// proxyA is always the smaller of the two proxy IDs, so the same two objects always produce the same pair.
+struct BroadphasePair
+{
+	int proxyA;
+	int proxyB;
+	GameObject* objectA;
+	GameObject* objectB;
+
+	BroadphasePair(int a, int b, GameObject* objA, GameObject* objB)
+	{
+		proxyA = a;
+		proxyB = b;
+		objectA = objA;
+		objectB = objB;
+	}
+	BroadphasePair()
+	{
+		proxyA = -1;
+		proxyB = -1;
+		objectA = nullptr;
+		objectB = nullptr;
+	}
+};
+
+// The order that FindPairs hands pairs back in: by proxyA, then by proxyB.
+inline bool PairLess(const BroadphasePair& a, const BroadphasePair& b)
+{
+	return a.proxyA < b.proxyA || (a.proxyA == b.proxyA && a.proxyB < b.proxyB);
+}
+
+// Puts the pairs in the order FindPairs hands them back in.
+inline void SortPairs(std::vector<BroadphasePair>& pairs)
+{
+	std::sort(pairs.begin(), pairs.end(), PairLess);
+}
+
+// When FindPairs is split across threads, every chunk of the work writes its pairs into its own list, so the threads never have to share one list (or lock
+// it). This gathers the first numChunks of those lists into pairs, and sorts them.
+inline void MergePairs(const std::vector<std::vector<BroadphasePair> >& chunkPairs, int numChunks, std::vector<BroadphasePair>& pairs)
+{
+	size_t total = 0;
+	for (int i = 0; i < numChunks; i++)
+	{
+		total += chunkPairs[i].size();
+	}
+
+	pairs.reserve(total);
+
+	for (int i = 0; i < numChunks; i++)
+	{
+		pairs.insert(pairs.end(), chunkPairs[i].begin(), chunkPairs[i].end());
+	}
+
+	SortPairs(pairs);
+}
+
+// The broadphase is the part of collision detection that cheaply throws away pairs of objects that can't possibly be touching, so that the more expensive
+// narrowphase test (in our case, TestAABB) only has to run on the handful of pairs that are actually close to each other.
+// Every object is registered with a broadphase as a "proxy", which is just an integer ID the broadphase hands back to you.
+class Broadphase
+{
+public:
+	virtual ~Broadphase() {}
+
+	// Registers a new box with the broadphase and returns the proxy ID that refers to it.
+	virtual int CreateProxy(const AABB& box, GameObject* object) = 0;
+
+	// Removes a proxy from the broadphase. The ID may be handed out again by a later CreateProxy.
+	virtual void DestroyProxy(int proxy) = 0;
+
+	// Tells the broadphase that the box of the given proxy has changed.
+	virtual void MoveProxy(int proxy, const AABB& box) = 0;
+
+	// Clears the given list and fills it with every pair of proxies whose boxes overlap, sorted with PairLess.
+	// If a job system is given, the search is split across its threads. The list comes out exactly the same either way (that's what the sort is for, since
+	// the threads finish in a different order every time), so a replay gives the same results no matter how many threads it runs on.
+	virtual void FindPairs(std::vector<BroadphasePair>& pairs, JobSystem* jobs = nullptr) = 0;
+
+	// Walks the broadphase to find every object whose proxy box one of the query's rays passes through (no further than the ray's reach), and hands each
+	// of them to query.Candidate.
+	// This only reads the broadphase, so any number of threads can cast rays at once (each with its own query), as long as nothing is changing it.
+	virtual void CastRays(RayQuery& query) const = 0;
+};
+
+#endif //_BROADPHASE_H
@@ -0,0 +1,560 @@
+/*
+Title: AABB-3D
+File Name: DynamicAABBTree.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _DYNAMIC_AABB_TREE_CPP
+#define _DYNAMIC_AABB_TREE_CPP
+
+#include "DynamicAABBTree.h"
+#include "Physics.h"
+#include <algorithm>
+
+// Returns the smallest box that contains both a and b.
+static AABB Union(const AABB& a, const AABB& b)
+{
+	return AABB(glm::min(a.min, b.min), glm::max(a.max, b.max));
+}
+
+// Returns the surface area of the box. This is what we try to keep small when deciding where to insert a leaf, since the chance of a random query hitting
+// a box is roughly proportional to its surface area.
+static float SurfaceArea(const AABB& box)
+{
+	glm::vec3 d = box.max - box.min;
+	return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+}
+
+// Returns true if the outer box completely contains the inner box.
+static bool Contains(const AABB& outer, const AABB& inner)
+{
+	return outer.min.x <= inner.min.x && outer.min.y <= inner.min.y && outer.min.z <= inner.min.z &&
+		inner.max.x <= outer.max.x && inner.max.y <= outer.max.y && inner.max.z <= outer.max.z;
+}
+
+DynamicAABBTree::DynamicAABBTree(float fatMargin)
+{
+	root = -1;
+	freeList = -1;
+	margin = fatMargin;
+}
+
+// Grabs a node from the free list, or adds a new one if the free list is empty.
+// Note that this can resize the nodes vector, so don't hold on to Node references across calls to this.
+int DynamicAABBTree::AllocateNode()
+{
+	int node;
+
+	if (freeList != -1)
+	{
+		node = freeList;
+		freeList = nodes[node].parent;
+	}
+	else
+	{
+		node = (int)nodes.size();
+		nodes.push_back(Node());
+	}
+
+	nodes[node].object = nullptr;
+	nodes[node].parent = -1;
+	nodes[node].child1 = -1;
+	nodes[node].child2 = -1;
+	nodes[node].height = 0;
+
+	return node;
+}
+
+void DynamicAABBTree::FreeNode(int node)
+{
+	nodes[node].parent = freeList;
+	nodes[node].object = nullptr;
+	nodes[node].height = -1;
+	freeList = node;
+}
+
+int DynamicAABBTree::CreateProxy(const AABB& box, GameObject* object)
+{
+	int proxy = AllocateNode();
+
+	// Fatten the box by the margin.
+	nodes[proxy].box = AABB(box.min - glm::vec3(margin), box.max + glm::vec3(margin));
+	nodes[proxy].tightBox = box;
+	nodes[proxy].object = object;
+	nodes[proxy].height = 0;
+
+	InsertLeaf(proxy);
+
+	return proxy;
+}
+
+void DynamicAABBTree::DestroyProxy(int proxy)
+{
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+}
+
+void DynamicAABBTree::MoveProxy(int proxy, const AABB& box)
+{
+	// The real box always gets updated, since FindPairs tests it.
+	nodes[proxy].tightBox = box;
+
+	// If the object is still inside its fat box, the tree doesn't need to change.
+	if (Contains(nodes[proxy].box, box))
+	{
+		return;
+	}
+
+	RemoveLeaf(proxy);
+
+	// Make a new fat box around the object.
+	nodes[proxy].box = AABB(box.min - glm::vec3(margin), box.max + glm::vec3(margin));
+
+	InsertLeaf(proxy);
+}
+
+void DynamicAABBTree::InsertLeaf(int leaf)
+{
+	if (root == -1)
+	{
+		root = leaf;
+		nodes[root].parent = -1;
+		return;
+	}
+
+	// Walk down the tree looking for the best sibling for the new leaf. At every level, we either stop and make the new leaf a sibling of the current node,
+	// or go down into whichever child would grow the least (in surface area) by having the leaf added to it.
+	AABB leafBox = nodes[leaf].box;
+	int index = root;
+
+	while (!nodes[index].IsLeaf())
+	{
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+
+		float area = SurfaceArea(nodes[index].box);
+		float combinedArea = SurfaceArea(Union(nodes[index].box, leafBox));
+
+		// The cost of creating a new parent for this node and the new leaf.
+		float cost = 2.0f * combinedArea;
+
+		// The minimum cost of pushing the leaf further down the tree (every node above the new leaf grows).
+		float inheritanceCost = 2.0f * (combinedArea - area);
+
+		// The cost of descending into each child.
+		float cost1 = SurfaceArea(Union(leafBox, nodes[child1].box)) + inheritanceCost;
+		if (!nodes[child1].IsLeaf())
+		{
+			cost1 -= SurfaceArea(nodes[child1].box);
+		}
+
+		float cost2 = SurfaceArea(Union(leafBox, nodes[child2].box)) + inheritanceCost;
+		if (!nodes[child2].IsLeaf())
+		{
+			cost2 -= SurfaceArea(nodes[child2].box);
+		}
+
+		if (cost < cost1 && cost < cost2)
+		{
+			break;
+		}
+
+		index = cost1 < cost2 ? child1 : child2;
+	}
+
+	int sibling = index;
+
+	// Create a new parent for the sibling and the leaf.
+	int oldParent = nodes[sibling].parent;
+	int newParent = AllocateNode();
+	nodes[newParent].parent = oldParent;
+	nodes[newParent].box = Union(leafBox, nodes[sibling].box);
+	nodes[newParent].height = nodes[sibling].height + 1;
+	nodes[newParent].child1 = sibling;
+	nodes[newParent].child2 = leaf;
+	nodes[sibling].parent = newParent;
+	nodes[leaf].parent = newParent;
+
+	if (oldParent != -1)
+	{
+		// The sibling was not the root, so point its old parent at the new parent.
+		if (nodes[oldParent].child1 == sibling)
+		{
+			nodes[oldParent].child1 = newParent;
+		}
+		else
+		{
+			nodes[oldParent].child2 = newParent;
+		}
+	}
+	else
+	{
+		// The sibling was the root.
+		root = newParent;
+	}
+
+	// Walk back up the tree, rebalancing and fixing the boxes and heights on the way.
+	index = nodes[leaf].parent;
+	while (index != -1)
+	{
+		index = Balance(index);
+
+		int child1 = nodes[index].child1;
+		int child2 = nodes[index].child2;
+
+		nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+		nodes[index].box = Union(nodes[child1].box, nodes[child2].box);
+
+		index = nodes[index].parent;
+	}
+}
+
+void DynamicAABBTree::RemoveLeaf(int leaf)
+{
+	if (leaf == root)
+	{
+		root = -1;
+		return;
+	}
+
+	int parent = nodes[leaf].parent;
+	int grandParent = nodes[parent].parent;
+	int sibling = nodes[parent].child1 == leaf ? nodes[parent].child2 : nodes[parent].child1;
+
+	if (grandParent != -1)
+	{
+		// Destroy the parent and connect the sibling to the grandparent.
+		if (nodes[grandParent].child1 == parent)
+		{
+			nodes[grandParent].child1 = sibling;
+		}
+		else
+		{
+			nodes[grandParent].child2 = sibling;
+		}
+		nodes[sibling].parent = grandParent;
+		FreeNode(parent);
+
+		// Walk back up the tree, rebalancing and shrinking the boxes on the way.
+		int index = grandParent;
+		while (index != -1)
+		{
+			index = Balance(index);
+
+			int child1 = nodes[index].child1;
+			int child2 = nodes[index].child2;
+
+			nodes[index].box = Union(nodes[child1].box, nodes[child2].box);
+			nodes[index].height = 1 + std::max(nodes[child1].height, nodes[child2].height);
+
+			index = nodes[index].parent;
+		}
+	}
+	else
+	{
+		root = sibling;
+		nodes[sibling].parent = -1;
+		FreeNode(parent);
+	}
+}
+
+// If one child of node A is more than one level taller than the other, rotate the taller child up into A's place.
+// Returns the index of the node that is now where A used to be.
+int DynamicAABBTree::Balance(int iA)
+{
+	if (nodes[iA].IsLeaf() || nodes[iA].height < 2)
+	{
+		return iA;
+	}
+
+	int iB = nodes[iA].child1;
+	int iC = nodes[iA].child2;
+
+	int balance = nodes[iC].height - nodes[iB].height;
+
+	// Rotate C up.
+	if (balance > 1)
+	{
+		int iF = nodes[iC].child1;
+		int iG = nodes[iC].child2;
+
+		// Swap A and C.
+		nodes[iC].child1 = iA;
+		nodes[iC].parent = nodes[iA].parent;
+		nodes[iA].parent = iC;
+
+		// A's old parent should point to C.
+		int cParent = nodes[iC].parent;
+		if (cParent != -1)
+		{
+			if (nodes[cParent].child1 == iA)
+			{
+				nodes[cParent].child1 = iC;
+			}
+			else
+			{
+				nodes[cParent].child2 = iC;
+			}
+		}
+		else
+		{
+			root = iC;
+		}
+
+		// Keep the taller of C's children under C, and hand the shorter one to A.
+		if (nodes[iF].height > nodes[iG].height)
+		{
+			nodes[iC].child2 = iF;
+			nodes[iA].child2 = iG;
+			nodes[iG].parent = iA;
+			nodes[iA].box = Union(nodes[iB].box, nodes[iG].box);
+			nodes[iC].box = Union(nodes[iA].box, nodes[iF].box);
+
+			nodes[iA].height = 1 + std::max(nodes[iB].height, nodes[iG].height);
+			nodes[iC].height = 1 + std::max(nodes[iA].height, nodes[iF].height);
+		}
+		else
+		{
+			nodes[iC].child2 = iG;
+			nodes[iA].child2 = iF;
+			nodes[iF].parent = iA;
+			nodes[iA].box = Union(nodes[iB].box, nodes[iF].box);
+			nodes[iC].box = Union(nodes[iA].box, nodes[iG].box);
+
+			nodes[iA].height = 1 + std::max(nodes[iB].height, nodes[iF].height);
+			nodes[iC].height = 1 + std::max(nodes[iA].height, nodes[iG].height);
+		}
+
+		return iC;
+	}
+
+	// Rotate B up.
+	if (balance < -1)
+	{
+		int iD = nodes[iB].child1;
+		int iE = nodes[iB].child2;
+
+		// Swap A and B.
+		nodes[iB].child1 = iA;
+		nodes[iB].parent = nodes[iA].parent;
+		nodes[iA].parent = iB;
+
+		// A's old parent should point to B.
+		int bParent = nodes[iB].parent;
+		if (bParent != -1)
+		{
+			if (nodes[bParent].child1 == iA)
+			{
+				nodes[bParent].child1 = iB;
+			}
+			else
+			{
+				nodes[bParent].child2 = iB;
+			}
+		}
+		else
+		{
+			root = iB;
+		}
+
+		// Keep the taller of B's children under B, and hand the shorter one to A.
+		if (nodes[iD].height > nodes[iE].height)
+		{
+			nodes[iB].child2 = iD;
+			nodes[iA].child1 = iE;
+			nodes[iE].parent = iA;
+			nodes[iA].box = Union(nodes[iC].box, nodes[iE].box);
+			nodes[iB].box = Union(nodes[iA].box, nodes[iD].box);
+
+			nodes[iA].height = 1 + std::max(nodes[iC].height, nodes[iE].height);
+			nodes[iB].height = 1 + std::max(nodes[iA].height, nodes[iD].height);
+		}
+		else
+		{
+			nodes[iB].child2 = iE;
+			nodes[iA].child1 = iD;
+			nodes[iD].parent = iA;
+			nodes[iA].box = Union(nodes[iC].box, nodes[iD].box);
+			nodes[iB].box = Union(nodes[iA].box, nodes[iE].box);
+
+			nodes[iA].height = 1 + std::max(nodes[iC].height, nodes[iD].height);
+			nodes[iB].height = 1 + std::max(nodes[iA].height, nodes[iE].height);
+		}
+
+		return iB;
+	}
+
+	return iA;
+}
+
+void DynamicAABBTree::FindPairs(std::vector<BroadphasePair>& pairs, JobSystem* jobs)
+{
+	pairs.clear();
+
+	if (jobs == nullptr)
+	{
+		QueryLeaves(0, (int)nodes.size(), pairs);
+		SortPairs(pairs);
+		return;
+	}
+
+	// Queries only read the tree, so the leaves can be split up between threads, each writing into its own list.
+	const int nodesPerJob = 256;
+	int numNodes = (int)nodes.size();
+	int numChunks = (numNodes + nodesPerJob - 1) / nodesPerJob;
+
+	if (chunkPairs.size() < (size_t)numChunks)
+	{
+		chunkPairs.resize(numChunks);
+	}
+
+	// ParallelFor can hand the body more than one chunk at once (it runs everything in a single call when there's only one thread), so we walk through the
+	// chunks in the range ourselves. That way every chunk's list is cleared and filled this step, and none are left over from an earlier one.
+	jobs->ParallelFor(numNodes, nodesPerJob, [this, nodesPerJob](int begin, int end)
+	{
+		for (int chunkBegin = begin; chunkBegin < end; chunkBegin += nodesPerJob)
+		{
+			std::vector<BroadphasePair>& chunk = chunkPairs[chunkBegin / nodesPerJob];
+			chunk.clear();
+			QueryLeaves(chunkBegin, std::min(chunkBegin + nodesPerJob, end), chunk);
+		}
+	});
+
+	MergePairs(chunkPairs, numChunks, pairs);
+}
+
+void DynamicAABBTree::QueryLeaves(int begin, int end, std::vector<BroadphasePair>& pairs) const
+{
+	// Query the tree once per leaf. Each query is O(log n), so this is O(n log n) overall.
+	// Every overlapping pair gets found twice (once from each side), so we only keep it when the other proxy has the bigger ID.
+	// We query with the leaf's real box, and then check the other leaf's real box too. The fat boxes only exist to keep the tree from changing every step,
+	// so two boxes that only overlap because of the margin aren't a pair. (If the real boxes overlap, the real box always overlaps the other fat box, so the
+	// query can't miss anything.)
+	for (int i = begin; i < end; i++)
+	{
+		if (nodes[i].height != 0)
+		{
+			continue;
+		}
+
+		const AABB& tightBox = nodes[i].tightBox;
+
+		Query(tightBox, [&](int other)
+		{
+			if (other > i && TestAABB(tightBox, nodes[other].tightBox))
+			{
+				pairs.push_back(BroadphasePair(i, other, nodes[i].object, nodes[other].object));
+			}
+			return true;
+		});
+	}
+}
+
+void DynamicAABBTree::CastRays(RayQuery& query) const
+{
+	if (root == -1)
+	{
+		return;
+	}
+
+	float distances[RayPacket::SIZE];
+
+	for (int first = 0; first < query.NumRays(); first += RayPacket::SIZE)
+	{
+		RayPacket packet;
+		int last = std::min(first + RayPacket::SIZE, query.NumRays());
+
+		for (int r = first; r < last; r++)
+		{
+			packet.Add(query.GetRay(r), query.Reach(r), r);
+		}
+
+		// A packet of rays that start near each other and head the same way (like the rays for the pixels of a screen, or the spread of a shotgun) mostly
+		// visits the same nodes, so testing them together means each node is only pulled in once. A ray that misses a node keeps getting tested against
+		// its children, but it can't hit them either (they're inside it), so it just comes along for the ride.
+		TraversalStack rayStack;
+		rayStack.Push(root);
+
+		while (!rayStack.Empty())
+		{
+			const Node& node = nodes[rayStack.Pop()];
+			unsigned int mask = RayPacketTestAABB(packet, node.box, distances);
+
+			if (mask == 0)
+			{
+				continue;
+			}
+
+			if (node.IsLeaf())
+			{
+				for (int k = 0; mask != 0; k++, mask >>= 1)
+				{
+					if (mask & 1)
+					{
+						query.Candidate(packet.ray[k], node.object);
+						packet.reach[k] = query.Reach(packet.ray[k]);
+					}
+				}
+				continue;
+			}
+
+			// Visit the child that's nearer along the first ray that hit this node first (by pushing it last). When only the closest hit is wanted,
+			// finding it early shrinks the reach of the rays, which lets them skip more of the tree.
+			int k = 0;
+			while (!(mask & (1u << k)))
+			{
+				k++;
+			}
+
+			glm::vec3 direction(1.0f / packet.inverseX[k], 1.0f / packet.inverseY[k], 1.0f / packet.inverseZ[k]);
+			const AABB& box1 = nodes[node.child1].box;
+			const AABB& box2 = nodes[node.child2].box;
+
+			if (glm::dot((box1.min + box1.max) - (box2.min + box2.max), direction) > 0.0f)
+			{
+				rayStack.Push(node.child1);
+				rayStack.Push(node.child2);
+			}
+			else
+			{
+				rayStack.Push(node.child2);
+				rayStack.Push(node.child1);
+			}
+		}
+	}
+}
+
+#endif // _DYNAMIC_AABB_TREE_CPP
@@ -0,0 +1,207 @@
+/*
+Title: AABB-3D
+File Name: DynamicAABBTree.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _DYNAMIC_AABB_TREE_H
+#define _DYNAMIC_AABB_TREE_H
+
+#include "Broadphase.h"
+
+// A dynamic bounding volume hierarchy (BVH): a binary tree where every leaf holds the box of one object, and every other node holds a box that contains both of
+// its children. To find everything that overlaps a box, we only walk down the branches whose boxes overlap it, which skips huge chunks of the scene at once.
+// The leaves store a "fat" box: the object's AABB grown by a margin. As long as the object's real AABB stays inside its fat box, moving it doesn't change the tree
+// at all. Only objects that leave their fat box get removed and reinserted, so scenes full of slow moving objects barely touch the tree every step.
+// Each leaf also remembers the real box, so FindPairs only reports pairs whose real boxes overlap (the same pairs the other broadphases find).
+// The tree is kept balanced with rotations (much like an AVL tree), so queries stay O(log n).
+// Proxy IDs are just the index of the leaf node.
+class DynamicAABBTree : public Broadphase
+{
+public:
+	// The stack of nodes still to visit during a query. A balanced tree is only a few dozen levels deep even with millions of leaves, so this lives in a
+	// fixed array and only spills onto the heap for unusually deep trees. (That keeps queries from allocating memory every time they run.)
+	struct TraversalStack
+	{
+		int fixed[64];
+		std::vector<int> overflow;
+		int count;
+
+		TraversalStack()
+		{
+			count = 0;
+		}
+		void Push(int value)
+		{
+			if (count < 64)
+			{
+				fixed[count] = value;
+			}
+			else
+			{
+				overflow.push_back(value);
+			}
+			count++;
+		}
+		int Pop()
+		{
+			count--;
+			if (count < 64)
+			{
+				return fixed[count];
+			}
+
+			int value = overflow.back();
+			overflow.pop_back();
+			return value;
+		}
+		bool Empty() const
+		{
+			return count == 0;
+		}
+	};
+
+private:
+	struct Node
+	{
+		AABB box;
+		GameObject* object;
+
+		// For leaves, the object's real (unfattened) box from the last CreateProxy or MoveProxy call.
+		AABB tightBox;
+
+		// The parent node, or the next free node when this node is in the free list.
+		int parent;
+
+		int child1;
+		int child2;
+
+		// Leaves have a height of 0, free nodes have a height of -1.
+		int height;
+
+		bool IsLeaf() const
+		{
+			return child1 == -1;
+		}
+	};
+
+	std::vector<Node> nodes;
+	int root;
+	int freeList;
+
+	// How much each leaf's box is grown on every side.
+	float margin;
+
+	int AllocateNode();
+	void FreeNode(int node);
+
+	void InsertLeaf(int leaf);
+	void RemoveLeaf(int leaf);
+	int Balance(int node);
+
+	// Queries the tree with every leaf from node begin up to node end, and adds the pairs it finds.
+	void QueryLeaves(int begin, int end, std::vector<BroadphasePair>& pairs) const;
+
+	// One list of pairs per chunk, when FindPairs is split across threads.
+	std::vector<std::vector<BroadphasePair> > chunkPairs;
+
+public:
+	DynamicAABBTree(float fatMargin = 0.1f);
+
+	int CreateProxy(const AABB& box, GameObject* object);
+	void DestroyProxy(int proxy);
+
+	// Moves a proxy to a new box. This only touches the tree if the box has left the proxy's fat box.
+	// The world already passes in the box swept over the step, so the fat box doesn't need to be stretched by the object's velocity on top of that.
+	void MoveProxy(int proxy, const AABB& box);
+
+	void FindPairs(std::vector<BroadphasePair>& pairs, JobSystem* jobs = nullptr);
+
+	// Walks the tree with 8 rays at a time, testing all of them against each node's box at once.
+	void CastRays(RayQuery& query) const;
+
+	// Calls callback(proxy) for every proxy whose fat box overlaps the given box. Return false from the callback to stop the query early.
+	// This only reads the tree, so it is safe to call from several threads at once as long as nothing is changing the tree.
+	template <typename T>
+	void Query(const AABB& box, T callback) const
+	{
+		if (root == -1)
+		{
+			return;
+		}
+
+		TraversalStack queryStack;
+		queryStack.Push(root);
+
+		while (!queryStack.Empty())
+		{
+			int index = queryStack.Pop();
+			const Node& node = nodes[index];
+
+			if (node.box.max.x < box.min.x || node.box.min.x > box.max.x) continue;
+			if (node.box.max.y < box.min.y || node.box.min.y > box.max.y) continue;
+			if (node.box.max.z < box.min.z || node.box.min.z > box.max.z) continue;
+
+			if (node.IsLeaf())
+			{
+				if (!callback(index))
+				{
+					return;
+				}
+			}
+			else
+			{
+				queryStack.Push(node.child1);
+				queryStack.Push(node.child2);
+			}
+		}
+	}
+
+	const AABB& GetFatAABB(int proxy) const
+	{
+		return nodes[proxy].box;
+	}
+	GameObject* GetObject(int proxy) const
+	{
+		return nodes[proxy].object;
+	}
+	int GetHeight() const
+	{
+		return root == -1 ? 0 : nodes[root].height;
+	}
+};
+
+#endif //_DYNAMIC_AABB_TREE_H
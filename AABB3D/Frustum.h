@@ -0,0 +1,105 @@
+/*
+Title: AABB-3D
+File Name: Frustum.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _FRUSTUM_H
+#define _FRUSTUM_H
+
+#include "AABB.h"
+
+// The view frustum: the six planes (left, right, bottom, top, near, far) that box in everything the camera can see.
+// Each plane is stored as a vec4 (a, b, c, d), so that a point p is on the inside of the plane when a * p.x + b * p.y + c * p.z + d >= 0.
+// The planes come straight out of the combined projection * view matrix (this is the Gribb/Hartmann method). A point is on screen when its clip space
+// x, y and z are all between -w and w, and each of those six comparisons works out to a plane made of two rows of the matrix added together.
+struct Frustum
+{
+	glm::vec4 planes[6];
+
+	Frustum()
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+	}
+
+	explicit Frustum(const glm::mat4& PV)
+	{
+		Extract(PV);
+	}
+
+	void Extract(const glm::mat4& PV)
+	{
+		// glm matrices are column major, so row i is PV[0][i], PV[1][i], PV[2][i], PV[3][i].
+		glm::vec4 rows[4];
+		for (int i = 0; i < 4; i++)
+		{
+			rows[i] = glm::vec4(PV[0][i], PV[1][i], PV[2][i], PV[3][i]);
+		}
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			planes[axis * 2] = rows[3] + rows[axis];		// -w <= x (or y, or z)
+			planes[axis * 2 + 1] = rows[3] - rows[axis];	// x (or y, or z) <= w
+		}
+	}
+
+	// Returns false if the box is completely outside of the frustum.
+	// For each plane we only need to check the corner of the box that's the furthest along the plane's normal: if even that corner is outside, the whole box
+	// is. This can let through a few boxes that sit just outside a corner of the frustum, but it never throws away a box that can be seen.
+	bool Intersects(const AABB& box) const
+	{
+		for (int i = 0; i < 6; i++)
+		{
+			const glm::vec4& plane = planes[i];
+
+			float x = plane.x >= 0.0f ? box.max.x : box.min.x;
+			float y = plane.y >= 0.0f ? box.max.y : box.min.y;
+			float z = plane.z >= 0.0f ? box.max.z : box.min.z;
+
+			if (plane.x * x + plane.y * y + plane.z * z + plane.w < 0.0f)
+			{
+				return false;
+			}
+		}
+
+		return true;
+	}
+};
+
+#endif //_FRUSTUM_H
@@ -42,31 +42,8 @@ simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
 
 #include "gl\glew.h"
 #include "glfw\glfw3.h"
-#include "glm\glm.hpp"
-#include "glm\gtc\matrix_transform.hpp"
-#include "glm\gtc\type_ptr.hpp"
-#include "glm\gtc\quaternion.hpp"
-#include "glm\gtx\quaternion.hpp"
 
-// We create a VertexFormat struct, which defines how the data passed into the shader code wil be formatted
-struct VertexFormat
-{
-	glm::vec4 color;	// A vector4 for color has 4 floats: red, green, blue, and alpha
-	glm::vec3 position;	// A vector3 for position has 3 float: x, y, and z coordinates
-
-	// Default constructor
-	VertexFormat()
-	{
-		color = glm::vec4(0.0f);
-		position = glm::vec3(0.0f);
-	}
-
-	// Constructor
-	VertexFormat(const glm::vec3 &pos, const glm::vec4 &iColor)
-	{
-		position = pos;
-		color = iColor;
-	}
-};
+// Everything that doesn't need OpenGL (glm and our vertex format) lives in MathIncludes.h, so that the physics code can be built without OpenGL.
+#include "MathIncludes.h"
 
 #endif _GL_INCLUDES_H
\ No newline at end of file
@@ -42,6 +42,12 @@ simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
 
 #include "GLIncludes.h"
 #include "GameObject.h"
+#include "Physics.h"
+#include "Scene.h"
+#include "PhysicsThread.h"
+#include "Frustum.h"
+#include "AABBStore.h"
+#include "PersistentBuffer.h"
 #include <string>
 #include <iostream>
 #include <fstream>
@@ -53,13 +59,24 @@ simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
 // This program will run on your GPU.
 GLuint program;
 
+// This program is the same, except it takes each object's MVP matrix as a per-instance attribute, for drawing with DrawInstanced.
+GLuint instancedProgram;
+
+// This program reads PV from a uniform buffer and every object's transformation matrix from a shader storage buffer, for drawing with renderStored.
+GLuint storedProgram;
+
 // These are your references to your actual compiled shaders
 GLuint vertex_shader;
+GLuint instanced_vertex_shader;
+GLuint stored_vertex_shader;
 GLuint fragment_shader;
 
 //This is a reference to your uniform MVP matrix in your vertex shader
 GLuint uniMVP;
 
+// This is a reference to the uniform in the stored program's vertex shader that says where the current draw call's objects start in the storage buffer.
+GLint uniFirstObject;
+
 // These are 4x4 transformation matrices, which you will locally modify before passing into the vertex shader via uniMVP
 glm::mat4 proj;
 glm::mat4 view;
@@ -69,15 +86,78 @@ glm::mat4 PV;
 
 // MVP is PV * Model (model is the transformation matrix of whatever object is being rendered)
 glm::mat4 MVP;
-glm::mat4 MVP2;
 
-// An array of vertices stored in a vector for our projects
-std::vector<VertexFormat> vertices;
-
-// References to our two GameObjects and the one Model we'll be using.
+// References to our GameObjects and the Models we'll be using.
+// The pyramid is only there so that the scene has more than one model in it, which makes sure every model gets drawn with its own vertices (and not
+// whichever model's buffers happened to be set up last).
 GameObject* obj1;
 GameObject* obj2;
+GameObject* obj3;
 Model* cube;
+Model* pyramid;
+
+// Every GameObject in the demo is created in this pool instead of with new, so spawning and despawning objects doesn't go to the heap each time.
+GameObjectPool pool;
+
+// The physics world holds every GameObject in the scene and runs the physics step on them.
+// It uses a SweepAndPrune broadphase by default. DynamicAABBTree (from DynamicAABBTree.h) can be swapped in with world.SetBroadphase, and is the better choice
+// for big scenes where most objects are barely moving. SpatialHashGrid (from SpatialHashGrid.h) is the better choice for big scenes where every object is
+// about the same size.
+PhysicsWorld world;
+
+// This is the number of seconds we intend for the physics to update.
+double physicsStep = 0.012;
+
+// Runs the physics step on its own thread. Once it has been started, only the physics thread touches the world and its objects, and the render thread only sees
+// the copies of their transforms that it hands over.
+PhysicsThread physicsThread(&world, physicsStep);
+
+// Spreads the per-object parts of each physics step (and of capturing the transforms for rendering) across every core.
+JobSystem jobs;
+
+// The transformation matrix of every object for the current frame, blended between the last two physics steps, and the model each one is drawn with.
+std::vector<glm::mat4> transforms;
+std::vector<Model*> transformModels;
+
+// When true, objects whose AABBs are completely outside the view are thrown away before anything gets built or uploaded for them. In a big world most
+// objects are off screen, so this skips most of the drawing work.
+bool useCulling = true;
+
+// The AABB of every object this frame, worked out from its blended transform, for frustum culling. These are kept around between frames so their memory
+// can be reused.
+AABBStore cullBoxes;
+
+// When true, every object that shares a model is drawn with a single instanced draw call. When false, each object gets its own uniform upload and draw call
+// (the way this demo originally worked), which is handy for comparing the two.
+bool useInstancing = true;
+
+// One batch per model for instanced drawing, holding the MVP matrices of every object drawn with that model this frame.
+// These are kept around between frames so their memory can be reused.
+std::vector<Model*> batchModels;
+std::vector<std::vector<glm::mat4>> batchMatrices;
+
+// When true (and the OpenGL version is new enough, 4.4 or later), every object's transformation matrix is written once per frame straight into a buffer that
+// stays mapped on the GPU, and the shader multiplies it by PV itself. There's no matrix multiply per object on the CPU and no upload call per object or per
+// model, just one small uniform and one draw call per model. When false (or not supported), useInstancing picks how to draw instead.
+bool useStorageBuffers = true;
+
+// The buffer holding PV for the camera, and the one holding every object's transformation matrix. Each one has three copies that get cycled through every
+// frame, so we never write over a copy the GPU is still drawing with. See PersistentBuffer.h.
+PersistentBuffer cameraBuffer(GL_UNIFORM_BUFFER);
+PersistentBuffer transformBuffer(GL_SHADER_STORAGE_BUFFER);
+
+// Where each batch's objects start in the transform buffer, and how many of them there are this frame. These line up with batchModels.
+std::vector<int> batchStarts;
+std::vector<int> batchCounts;
+
+// Which batch each object in transforms goes in this frame.
+std::vector<int> objectBatches;
+
+// Times each phase of the physics step and the rendering. See Profiler.h.
+Profiler profiler;
+
+// Where the Chrome trace of the whole run gets written when the program closes. Open it in chrome://tracing or https://ui.perfetto.dev.
+std::string traceFile = "../profile_trace.json";
 
 // Speed of the moving object
 float speed = 0.90f;
@@ -164,34 +244,23 @@ GLuint createShader(std::string sourceCode, GLenum shaderType)
 
 void setupCube()
 {
-	// An element array, which determines which of the vertices to display in what order. This is sometimes known as an index array.
-	GLuint elements[] = {
-		0, 1, 2, 0, 2, 3, 3, 2, 4, 3, 4, 5, 5, 4, 6, 5, 6, 7, 7, 6, 1, 7, 1, 0, 1, 6, 4, 1, 4, 2, 7, 0, 3, 7, 3, 5
-	};
-	// These are the indices for a cube.
-	vertices.push_back(VertexFormat(glm::vec3(-0.25, -0.25, 0.25),		// Front, Bottom, Left		0
-		glm::vec4(1.0, 0.0, 0.0, 1.0))); //red
-	vertices.push_back(VertexFormat(glm::vec3(-0.25, 0.25, 0.25),		// Front, Top, Left			1
-		glm::vec4(1.0, 0.0, 0.0, 1.0))); //red
-	vertices.push_back(VertexFormat(glm::vec3(0.25, 0.25, 0.25),		// Front, Top, Right		2
-		glm::vec4(1.0, 0.0, 1.0, 1.0))); //yellow
-	vertices.push_back(VertexFormat(glm::vec3(0.25, -0.25, 0.25),		// Front, Bottom, Right		3
-		glm::vec4(1.0, 0.0, 1.0, 1.0))); //yellow
-	vertices.push_back(VertexFormat(glm::vec3(0.25, 0.25, -0.25),		// Back, Top, Right			4
-		glm::vec4(0.0, 1.0, 1.0, 1.0))); //cyan
-	vertices.push_back(VertexFormat(glm::vec3(0.25, -0.25, -0.25),		// Back, Bottom, Right		5
-		glm::vec4(0.0, 1.0, 1.0, 1.0))); //cyan
-	vertices.push_back(VertexFormat(glm::vec3(-0.25, 0.25, -0.25),		// Back, Top, Left			6
-		glm::vec4(0.0, 1.0, 0.0, 1.0))); //blue
-	vertices.push_back(VertexFormat(glm::vec3(-0.25, -0.25, -0.25),		// Back, Bottom, Left		7
-		glm::vec4(0.0, 1.0, 0.0, 1.0))); //blue
-
-										 // Create our cube model from the calculated data.
-	cube = new Model(vertices.size(), vertices.data(), 36, elements);
+	// Create our cube model. (The vertex and index data lives in CreateCubeModel, since the headless program uses the same cube.)
+	cube = CreateCubeModel();
+
+	// Send the cube's vertices to the GPU so we can draw it.
+	cube->Commit();
+
+	// The same goes for the pyramid.
+	pyramid = CreatePyramidModel();
+	pyramid->Commit();
 
 	// Create two GameObjects based off of the cube model (note that they are both holding pointers to the cube, not actual copies of the cube vertex data).
-	obj1 = new GameObject(cube);
-	obj2 = new GameObject(cube);
+	// They live in the pool, which hands back a handle. Pointers to pooled objects stay good until the object is destroyed, so we just keep those.
+	obj1 = pool.Get(pool.Create(cube));
+	obj2 = pool.Get(pool.Create(cube));
+
+	// And one GameObject with the pyramid, which sits still up and out of the way of the moving cube.
+	obj3 = pool.Get(pool.Create(pyramid));
 
 	// Set beginning properties of GameObjects.
 	obj1->SetVelocity(glm::vec3(0, 0.0f, 0.0f)); // The first object doesn't move.
@@ -200,6 +269,24 @@ void setupCube()
 	obj2->SetPosition(glm::vec3(0.7f, 0.0f, 0.0f));
 	obj1->SetScale(glm::vec3(0.75f, 0.75f, 0.75f));
 	obj2->SetScale(glm::vec3(0.25f, 0.25f, 0.25f));
+	obj3->SetVelocity(glm::vec3(0.0f, 0.0f, 0.0f));
+	obj3->SetPosition(glm::vec3(-0.6f, 0.5f, 0.0f));
+	obj3->SetScale(glm::vec3(0.75f, 0.75f, 0.75f));
+
+	// Add the objects to the physics world. This calculates their AABBs and registers them with the broadphase.
+	world.AddObject(obj1);
+	world.AddObject(obj2);
+	world.AddObject(obj3);
+
+	// Keep the moving object inside the screen by bouncing it off of these walls.
+	world.SetBounds(glm::vec3(0.9f, 0.8f, 1.0f));
+
+	// Time every physics step, and record a trace of the whole run.
+	world.SetProfiler(&profiler);
+	profiler.StartTrace();
+
+	// Spread the per-object phases of the step across every core.
+	world.SetJobSystem(&jobs);
 }
 
 // Initialization code
@@ -216,10 +303,12 @@ void init()
 	// Read in the shader code from a file.
 	std::string vertShader = readShader("../Assets/VertexShader.glsl");
 	std::string fragShader = readShader("../Assets/FragmentShader.glsl");
+	std::string instancedVertShader = readShader("../Assets/InstancedVertexShader.glsl");
 
 	// createShader consolidates all of the shader compilation code
 	vertex_shader = createShader(vertShader, GL_VERTEX_SHADER);
 	fragment_shader = createShader(fragShader, GL_FRAGMENT_SHADER);
+	instanced_vertex_shader = createShader(instancedVertShader, GL_VERTEX_SHADER);
 
 	// A shader is a program that runs on your GPU instead of your CPU. In this sense, OpenGL refers to your groups of shaders as "programs".
 	// Using glCreateProgram creates a shader program and returns a GLuint reference to it.
@@ -229,6 +318,12 @@ void init()
 
 												// This links the program, using the vertex and fragment shaders to create executables to run on the GPU.
 	glLinkProgram(program);
+
+	// The instanced program shares the fragment shader with the regular one.
+	instancedProgram = glCreateProgram();
+	glAttachShader(instancedProgram, instanced_vertex_shader);
+	glAttachShader(instancedProgram, fragment_shader);
+	glLinkProgram(instancedProgram);
 	// End of shader and program creation
 
 	// This gets us a reference to the uniform variable in the vertex shader, which is called "MVP".
@@ -236,6 +331,28 @@ void init()
 	// Only 2 parameters required: A reference to the shader program and the name of the uniform variable within the shader code.
 	uniMVP = glGetUniformLocation(program, "MVP");
 
+	// The storage buffer path needs OpenGL 4.3 for shader storage buffers, and 4.4 (or ARB_buffer_storage) for buffers that stay mapped. If we don't have
+	// them, fall back to the other ways of drawing.
+	if (useStorageBuffers && (!GLEW_VERSION_4_3 || !PersistentBuffer::Supported()))
+	{
+		std::cout << "Persistently mapped buffers aren't supported, so the objects will be drawn without them." << std::endl;
+		useStorageBuffers = false;
+	}
+
+	if (useStorageBuffers)
+	{
+		// This also shares the fragment shader with the regular program.
+		std::string storedVertShader = readShader("../Assets/StorageVertexShader.glsl");
+		stored_vertex_shader = createShader(storedVertShader, GL_VERTEX_SHADER);
+
+		storedProgram = glCreateProgram();
+		glAttachShader(storedProgram, stored_vertex_shader);
+		glAttachShader(storedProgram, fragment_shader);
+		glLinkProgram(storedProgram);
+
+		uniFirstObject = glGetUniformLocation(storedProgram, "firstObject");
+	}
+
 	// Creates the view matrix using glm::lookAt.
 	// First parameter is camera position, second parameter is point to be centered on-screen, and the third paramter is the up axis.
 	view = glm::lookAt(glm::vec3(0.0f, 0.0f, 2.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
@@ -247,14 +364,6 @@ void init()
 	// Allows us to make one less calculation per frame, as long as we don't update the projection and view matrices every frame.
 	PV = proj * view;
 
-	// Create your MVP matrices based on the objects' transforms.
-	MVP = PV * *obj1->GetTransform();
-	MVP2 = PV * *obj2->GetTransform();
-
-	// Calculate the Axis-Aligned Bounding Box for your object.
-	obj1->CalculateAABB();
-	obj2->CalculateAABB();
-
 	// This is not necessary, but I prefer to handle my vertices in the clockwise order. glFrontFace defines which face of the triangles you're drawing is the front.
 	// Essentially, if you draw your vertices in counter-clockwise order, by default (in OpenGL) the front face will be facing you/the screen. If you draw them clockwise, the front face 
 	// will face away from you. By passing in GL_CW to this function, we are saying the opposite, and now the front face will face you if you draw in the clockwise order.
@@ -277,44 +386,245 @@ void cleanup()
 {
 	// After the program is over, cleanup your data!
 	glDeleteShader(vertex_shader);
+	glDeleteShader(instanced_vertex_shader);
 	glDeleteShader(fragment_shader);
 	glDeleteProgram(program);
+	glDeleteProgram(instancedProgram);
+	glDeleteShader(stored_vertex_shader);
+	glDeleteProgram(storedProgram);
 	// Note: If at any point you stop using a "program" or shaders, you should free the data up then and there.
 
-	delete(obj1);
-	delete(obj2);
+	// Stop the physics thread before we get rid of anything it might be using.
+	physicsThread.Stop();
+
+	if (profiler.WriteTrace(traceFile))
+	{
+		std::cout << "Wrote profiler trace to " << traceFile << std::endl;
+	}
+
+	world.Clear();
+	pool.Clear();
+
+	cameraBuffer.Release();
+	transformBuffer.Release();
+
+	cube->ReleaseBuffer();
 	delete(cube);
 
+	pyramid->ReleaseBuffer();
+	delete(pyramid);
+
 	// Frees up GLFW memory
 	glfwTerminate();
 }
 
+// Throws away every object whose AABB is completely outside the view frustum, leaving only the ones that might be visible in transforms and
+// transformModels (in the same order as before).
+// The render thread doesn't own the GameObjects (the physics thread does), so instead of asking them for their AABBs, we work out each box the same way
+// GameObject does, from its model's local box and this frame's blended transform. That also means the boxes line up with where the objects are actually
+// drawn this frame. The boxes are then tested against the frustum 8 at a time.
+void cullObjects()
+{
+	ScopedTimer timer(&profiler, PROFILE_CULL);
+
+	Frustum frustum(PV);
+
+	cullBoxes.Clear();
+	cullBoxes.Reserve((int)transforms.size());
+
+	for (size_t i = 0; i < transforms.size(); i++)
+	{
+		cullBoxes.Add(TransformAABB(transformModels[i]->LocalAABB(), transforms[i]));
+	}
+
+	// Slide every visible object down over the ones that were thrown away.
+	int numBlocks = (cullBoxes.Size() + 7) / 8;
+	size_t visible = 0;
+
+	for (int block = 0; block < numBlocks; block++)
+	{
+		unsigned int mask = cullBoxes.FrustumMask8(frustum, block);
+
+		for (int k = 0; mask != 0; k++, mask >>= 1)
+		{
+			if (mask & 1)
+			{
+				size_t i = block * 8 + k;
+				transforms[visible] = transforms[i];
+				transformModels[visible] = transformModels[i];
+				visible++;
+			}
+		}
+	}
+
+	transforms.resize(visible);
+	transformModels.resize(visible);
+}
+
+// Draws each object with its own uniform upload and draw call.
+void renderIndividually()
+{
+	// Tell OpenGL to use the shader program you've created.
+	glUseProgram(program);
+
+	for (size_t i = 0; i < transforms.size(); i++)
+	{
+		// Update the MVP matrix based on the object's transform, and set the uniform matrix in our shader to it.
+		MVP = PV * transforms[i];
+		glUniformMatrix4fv(uniMVP, 1, GL_FALSE, glm::value_ptr(MVP));
+
+		// Draw the model.
+		transformModels[i]->Draw();
+	}
+}
+
+// Returns the index of the batch for the given model, adding one if this is the first time we've seen it.
+// There are only ever a handful of models, so a linear search is plenty fast.
+size_t findBatch(Model* model)
+{
+	size_t batch = 0;
+	while (batch < batchModels.size() && batchModels[batch] != model)
+	{
+		batch++;
+	}
+
+	if (batch == batchModels.size())
+	{
+		batchModels.push_back(model);
+		batchMatrices.push_back(std::vector<glm::mat4>());
+	}
+
+	return batch;
+}
+
+// Draws every object that shares a model with one instanced draw call, so the number of draw calls depends on the number of models rather than the
+// number of objects.
+void renderInstanced()
+{
+	// Empty out last frame's batches, keeping their memory.
+	for (size_t i = 0; i < batchMatrices.size(); i++)
+	{
+		batchMatrices[i].clear();
+	}
+
+	// Sort each object's MVP matrix into the batch for its model.
+	for (size_t i = 0; i < transforms.size(); i++)
+	{
+		batchMatrices[findBatch(transformModels[i])].push_back(PV * transforms[i]);
+	}
+
+	glUseProgram(instancedProgram);
+
+	for (size_t i = 0; i < batchModels.size(); i++)
+	{
+		if (!batchMatrices[i].empty())
+		{
+			batchModels[i]->DrawInstanced(&batchMatrices[i][0], (int)batchMatrices[i].size());
+		}
+	}
+}
+
+// Draws every object that shares a model with one instanced draw call, like renderInstanced, except that nothing is uploaded. PV goes into the camera's
+// uniform buffer, and each object's transformation matrix is written straight into the mapped storage buffer, grouped by model. The shader multiplies
+// the two together for each vertex, so the CPU never works out an MVP matrix at all.
+void renderStored()
+{
+	if (transforms.empty())
+	{
+		return;
+	}
+
+	// Count how many objects use each model, so we know where each batch starts in the buffer.
+	objectBatches.resize(transforms.size());
+
+	for (size_t i = 0; i < transforms.size(); i++)
+	{
+		objectBatches[i] = (int)findBatch(transformModels[i]);
+	}
+
+	batchStarts.assign(batchModels.size(), 0);
+	batchCounts.assign(batchModels.size(), 0);
+
+	for (size_t i = 0; i < objectBatches.size(); i++)
+	{
+		batchCounts[objectBatches[i]]++;
+	}
+
+	for (size_t i = 1; i < batchStarts.size(); i++)
+	{
+		batchStarts[i] = batchStarts[i - 1] + batchCounts[i - 1];
+	}
+
+	// Write this frame's data. Begin waits (if it has to) for the GPU to finish with the copy we're about to write into.
+	glm::mat4* camera = (glm::mat4*)cameraBuffer.Begin(sizeof(glm::mat4));
+	*camera = PV;
+
+	glm::mat4* models = (glm::mat4*)transformBuffer.Begin(sizeof(glm::mat4) * transforms.size());
+
+	// Each batch's count gets counted back up from zero as its matrices are written in.
+	batchCounts.assign(batchModels.size(), 0);
+
+	for (size_t i = 0; i < transforms.size(); i++)
+	{
+		int batch = objectBatches[i];
+		models[batchStarts[batch] + batchCounts[batch]] = transforms[i];
+		batchCounts[batch]++;
+	}
+
+	glUseProgram(storedProgram);
+
+	// These binding points match the ones in StorageVertexShader.glsl.
+	cameraBuffer.Bind(0, 0, sizeof(glm::mat4));
+	transformBuffer.Bind(1, 0, sizeof(glm::mat4) * transforms.size());
+
+	for (size_t i = 0; i < batchModels.size(); i++)
+	{
+		if (batchCounts[i] > 0)
+		{
+			glUniform1i(uniFirstObject, batchStarts[i]);
+			batchModels[i]->DrawInstances(batchCounts[i]);
+		}
+	}
+
+	// Every draw call that reads this frame's copies has been made, so fence them off until the GPU is done.
+	cameraBuffer.End();
+	transformBuffer.End();
+}
+
 // This function runs every frame
 void renderScene()
 {
+	ScopedTimer timer(&profiler, PROFILE_RENDER);
+
 	// Clear the color buffer and the depth buffer
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	// Clear the screen to white
 	glClearColor(1.0, 1.0, 1.0, 1.0);
 
-	// Tell OpenGL to use the shader program you've created.
-	glUseProgram(program);
-
-	// Set the uniform matrix in our shader to our MVP matrix for the first object.
-	glUniformMatrix4fv(uniMVP, 1, GL_FALSE, glm::value_ptr(MVP));
-
-	// Draw the cube.
-	cube->Draw();
-
-	// Set the uniform matrix in our shader to our MVP matrix for the second object.
-	glUniformMatrix4fv(uniMVP, 1, GL_FALSE, glm::value_ptr(MVP2));
+	// Get the objects' transforms for this frame from the physics thread. If it hasn't finished its first step yet, there's nothing to draw.
+	if (!physicsThread.Interpolate(transforms, &transformModels))
+	{
+		return;
+	}
 
-	// Draw the cube again.
-	cube->Draw();
+	if (useCulling)
+	{
+		cullObjects();
+	}
 
-	// We're using the same model here to draw, but different transformation matrices so that we can use less data overall.
-	// This is a technique called instancing, although "true" instancing involves binding a matrix array to the uniform variable and using DrawInstanced in place of draw.
+	if (useStorageBuffers)
+	{
+		renderStored();
+	}
+	else if (useInstancing)
+	{
+		renderInstanced();
+	}
+	else
+	{
+		renderIndividually();
+	}
 }
 
 #endif _GL_RENDER_H
\ No newline at end of file
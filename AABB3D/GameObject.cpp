@@ -61,85 +61,192 @@ GameObject::GameObject(Model* inModel)
 
 	// And a default quaternion.
 	quaternion = glm::quat();
+
+	// Use the fast AABB calculation unless asked otherwise.
+	tightAABB = false;
+
+	// Not registered with a broadphase yet.
+	proxy = -1;
+
+	// And not in a motion store either, so the position, velocity and acceleration above are the real ones.
+	motion = nullptr;
+	motionIndex = -1;
+	motionVersion = 0;
+
+	// Everything starts out awake.
+	asleep = false;
+	restingSteps = 0;
+	angularMotion = 0.0f;
+
+	// The matrices above are already correct, but the AABB hasn't been worked out yet.
+	transformDirty = false;
+	boxDirty = true;
 }
 
 void GameObject::Update(float dt)
 {
 	// Do basic physics calcuations based on dt.
-	velocity += acceleration * dt;
-	position += velocity * dt;
+	// (If the object is in a motion store, its owner should be calling MotionStore::Integrate instead, which does this for every object at once.)
+	glm::vec3 newVelocity = GetVelocity() + GetAcceleration() * dt;
+	SetVelocity(newVelocity);
 
-	// Set the translation equal to the new position of the object.
-	SetTranslation(position); // Note that this will also recalculate the transformation matrix.
+	// Set the position (and the translation) to the new position of the object. Note that this will also mark the transformation matrix as out of date.
+	SetPosition(GetPosition() + newVelocity * dt);
 }
 
-void GameObject::CalculateAABB()
+void GameObject::AttachMotion(MotionStore* store)
+{
+	if (motion != nullptr)
+	{
+		DetachMotion();
+	}
+
+	motionIndex = store->Add(position, velocity, acceleration);
+	motion = store;
+	motionVersion = store->GetVersion();
+	motion->SetAwake(motionIndex, !asleep);
+}
+
+void GameObject::Wake()
+{
+	restingSteps = 0;
+
+	if (!asleep)
+	{
+		return;
+	}
+
+	asleep = false;
+
+	if (motion != nullptr)
+	{
+		motion->SetAwake(motionIndex, true);
+	}
+}
+
+void GameObject::Sleep()
 {
-	// Create local variables for the vertices of the model.
-	VertexFormat* vertexArray = model->Vertices();
-	int numVertexArray = model->NumVertices();
+	// Catch the matrices up with where the object stopped, since they won't be updated again while it sleeps.
+	SyncMotion();
 
-	// Create a temporary AABB that uses vec4 for the purposes of matrix multiplication.
-	CalculatorAABB newBox;
+	asleep = true;
+	angularMotion = 0.0f;
 
-	// Set the min and max equal to the first vertex in the object times the transformation matrix.
-	newBox.min = transformation * glm::vec4(vertexArray[0].position, 1.0f);
-	newBox.max = newBox.min;
+	// Stop it completely, so that it doesn't drift off at whatever tiny speed it had when it wakes back up. (We go straight to the store here, since
+	// SetVelocity would wake it right back up.)
+	if (motion != nullptr)
+	{
+		motion->SetVelocity(motionIndex, glm::vec3(0.0f));
+		motion->SetAwake(motionIndex, false);
+	}
+	else
+	{
+		velocity = glm::vec3(0.0f);
+	}
+}
 
-	// Loop through the rest of the vertices.
-	for (int i = 1; i < numVertexArray; i++)
+bool GameObject::UpdateSleep(float dt, float linearThreshold, float angularThreshold, int stepsToSleep)
+{
+	if (asleep)
 	{
-		// Create a temporary vertex that is the vertices at index i turned into a vector4 and modified by the transformation matrix.
-		glm::vec4 tempVert = transformation * glm::vec4(vertexArray[i].position, 1.0f);
-
-		// If this vertex has a value larger than the max value of our newBox, replace the newBox max value with that value.
-		if (tempVert.x > newBox.max.x)
-		{
-			newBox.max.x = tempVert.x;
-		}
-		if (tempVert.y > newBox.max.y)
-		{
-			newBox.max.y = tempVert.y;
-		}
-		if (tempVert.z > newBox.max.z)
-		{
-			newBox.max.z = tempVert.z;
-		}
-
-		// Do the same for the minimum value.
-		if (tempVert.x < newBox.min.x)
-		{
-			newBox.min.x = tempVert.x;
-		}
-		if (tempVert.y < newBox.min.y)
-		{
-			newBox.min.y = tempVert.y;
-		}
-		if (tempVert.z < newBox.min.z)
-		{
-			newBox.min.z = tempVert.z;
-		}
+		return true;
 	}
 
-	// Now set the actual AABB min/max (vec3 instead of vec4) to be stored in this GameObject.
-	box.min.x = newBox.min.x;
-	box.min.y = newBox.min.y;
-	box.min.z = newBox.min.z;
-	box.max.x = newBox.max.x;
-	box.max.y = newBox.max.y;
-	box.max.z = newBox.max.z;
+	float angularSpeed = angularMotion / dt;
+	angularMotion = 0.0f;
+
+	if (glm::length(GetVelocity()) >= linearThreshold || angularSpeed >= angularThreshold)
+	{
+		restingSteps = 0;
+		return false;
+	}
+
+	// Stop counting once it's high enough, so that an object waiting on the rest of its island can't overflow it.
+	if (restingSteps < stepsToSleep)
+	{
+		restingSteps++;
+	}
+
+	return restingSteps >= stepsToSleep;
+}
+
+void GameObject::DetachMotion()
+{
+	if (motion == nullptr)
+	{
+		return;
+	}
+
+	// Make sure the translation matrix has caught up with the store before we lose track of it.
+	SyncMotion();
+
+	position = motion->GetPosition(motionIndex);
+	velocity = motion->GetVelocity(motionIndex);
+	acceleration = motion->GetAcceleration(motionIndex);
+
+	motion = nullptr;
+	motionIndex = -1;
+}
+
+void GameObject::CalculateAABB()
+{
+	// Both ways of working out the AABB need an up to date transformation matrix.
+	if (transformDirty)
+	{
+		CalculateMatrices();
+	}
+
+	boxDirty = false;
+
+	if (tightAABB)
+	{
+		CalculateTightAABB();
+		return;
+	}
+
+	// Instead of transforming every vertex, we transform the model's local space box (see TransformAABB). This is O(1) no matter how many vertices the
+	// model has.
+	box = TransformAABB(model->LocalAABB(), transformation);
+}
+
+// Transforms every single vertex of the model to find the exact AABB. This is O(vertices), so only use it (through SetTightAABB) when you really need it.
+// The model does the actual work, since it keeps a copy of the positions laid out for SIMD (see Model::TransformedAABB).
+void GameObject::CalculateTightAABB()
+{
+	box = model->TransformedAABB(transformation);
 }
 
 // Calculates the transformation matrix based on translation, then rotation, then scale.
 void GameObject::CalculateMatrices()
 {
-	transformation = translation * rotation * scale;
+	transformation = rotation * scale;
+
+	// This is the same as translation * transformation, without doing a whole matrix multiply. Multiplying by a translation matrix just adds the
+	// translation (times the w value) to each column.
+	glm::vec4 offset = glm::vec4(glm::vec3(translation[3]), 0.0f);
+
+	for (int i = 0; i < 4; i++)
+	{
+		transformation[i] += offset * transformation[i][3];
+	}
+
+	transformDirty = false;
 }
 
 // Adds the incoming vec3 pos to the position, and then translates the object to that position.
 void GameObject::AddPosition(glm::vec3 pos)
 {
-	position += pos;
+	Wake();
+	SyncMotion();
+
+	if (motion != nullptr)
+	{
+		motion->SetPosition(motionIndex, motion->GetPosition(motionIndex) + pos);
+	}
+	else
+	{
+		position += pos;
+	}
 
 	Translate(pos);
 }
@@ -147,40 +254,51 @@ void GameObject::AddPosition(glm::vec3 pos)
 // Adds the incoming vec3 vel to the velocity.
 void GameObject::AddVelocity(glm::vec3 vel)
 {
-	velocity += vel;
+	SetVelocity(GetVelocity() + vel);
 }
 
 // Adds the incoming vec3 accel to the acceleration.
 void GameObject::AddAcceleration(glm::vec3 accel)
 {
-	acceleration += accel;
+	SetAcceleration(GetAcceleration() + accel);
 }
 
 // Scales the current scale value by the x, y and z values given. (So if the scale is [0.5, 0.5, 0.5] and we pass in [0.5, 0.5, 0.5] we end up with [0.25, 0.25, 0.25].)
 void GameObject::Scale(glm::vec3 scaleFactor)
 {
+	Wake();
+
 	// Scales the scale matrix.
 	scale = glm::scale(scale, scaleFactor);
 
-	// Then we have to recalculate the transformation matrix.
-	CalculateMatrices();
+	// Then the transformation matrix has to be recalculated (the next time it's needed).
+	MarkDirty();
 }
 
 // Sets the scale in the x, y, and z position to the given values.
 void GameObject::SetScale(glm::vec3 scaleFactor)
 {
+	Wake();
+
 	// Scales the identity matrix.
 	scale = glm::scale(glm::mat4(), scaleFactor);
 
-	// Then we have to recalculate the transformation matrix.
-	CalculateMatrices();
+	// Then the transformation matrix has to be recalculated (the next time it's needed).
+	MarkDirty();
 }
 
 // Rotates in x, y, and z radians based on given values.
 void GameObject::Rotate(glm::vec3 rotFactor)
 {
 	// WARNING: These are interpreted as radian values, so be sure to specify them not as degrees.
-	
+
+	// Rotating a sleeping object wakes it up. Otherwise, keep track of how much it's turning, since an object that's spinning isn't resting.
+	if (asleep)
+	{
+		Wake();
+	}
+	angularMotion += glm::length(rotFactor);
+
 	// Create a quaternion based on the euler angles given.
 	glm::quat q = glm::quat(rotFactor);
 
@@ -190,23 +308,26 @@ void GameObject::Rotate(glm::vec3 rotFactor)
 	// Turn our quaternion into a mat4.
 	rotation = glm::toMat4(quaternion);
 
-	// Then we have to recalculate the transformation matrix.
-	CalculateMatrices();
+	// Then the transformation matrix has to be recalculated (the next time it's needed).
+	MarkDirty();
 }
 
 // Sets the rotation matrix to a given value.
 void GameObject::SetRotation(glm::mat4* rotMatrix)
 {
+	Wake();
+
 	rotation = *rotMatrix;
 
-	// Then we have to recalculate the transformation matrix.
-	CalculateMatrices();
+	// Then the transformation matrix has to be recalculated (the next time it's needed).
+	MarkDirty();
 }
 
 // Sets the rotation matrix to a given value of x, y, and z radians.
 void GameObject::SetRotation(glm::vec3 rotFactor)
 {
 	// WARNING: These are interpreted as radian values, so be sure to specify them not as degrees.
+	Wake();
 
 	// Set our quaternion equal to a quaternion created from the given euler angles.
 	quaternion = glm::quat(rotFactor);
@@ -214,18 +335,20 @@ void GameObject::SetRotation(glm::vec3 rotFactor)
 	// Turn our quaternion into a mat4.
 	rotation = glm::toMat4(quaternion);
 
-	// Then we have to recalculate the transformation matrix.
-	CalculateMatrices();
+	// Then the transformation matrix has to be recalculated (the next time it's needed).
+	MarkDirty();
 }
 
 // Translates in the x, y, and z directions based on the given values.
 void GameObject::Translate(glm::vec3 transFactor)
 {
+	Wake();
+
 	// Translates the translation matrix.
 	translation = glm::translate(translation, transFactor);
 
-	// Then we have to recalculate the transformation matrix.
-	CalculateMatrices();
+	// Then the transformation matrix has to be recalculated (the next time it's needed).
+	MarkDirty();
 }
 
 // Sets the translations to the exact x, y, and z position values given.
@@ -234,8 +357,8 @@ void GameObject::SetTranslation(glm::vec3 transFactor)
 	// Translates the identity matrix.
 	translation = glm::translate(glm::mat4(), transFactor);
 
-	// Then we have to recalculate the transformation matrix.
-	CalculateMatrices();
+	// Then the transformation matrix has to be recalculated (the next time it's needed).
+	MarkDirty();
 }
 
 #endif // _GAME_OBJECT_CPP
\ No newline at end of file
@@ -41,40 +41,7 @@ simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
 #define _GAME_OBJECT_H
 
 #include "Model.h"
-
-struct AABB
-{
-	glm::vec3 min;
-	glm::vec3 max;
-
-	AABB(const glm::vec3 &minVal, const glm::vec3 &maxVal)
-	{
-		min = minVal;
-		max = maxVal;
-	}
-	AABB()
-	{
-		min = glm::vec3(0.0f);
-		max = glm::vec3(0.0f);
-	}
-};
-
-struct CalculatorAABB
-{
-	glm::vec4 min;
-	glm::vec4 max;
-
-	CalculatorAABB(const glm::vec4 &minVal, const glm::vec4 &maxVal)
-	{
-		min = minVal;
-		max = maxVal;
-	}
-	CalculatorAABB()
-	{
-		min = glm::vec4(0.0f);
-		max = glm::vec4(0.0f);
-	}
-};
+#include "MotionStore.h"
 
 class GameObject
 {
@@ -92,6 +59,59 @@ class GameObject
 	Model* model;
 	AABB box;
 
+	// Changing the translation, rotation or scale doesn't rebuild the transformation matrix or the AABB right away. It just marks them as out of date,
+	// and they get rebuilt (once) the next time something asks for them through GetTransform or GetAABB. That way moving, rotating and scaling an object in
+	// the same step only costs one rebuild instead of three.
+	bool transformDirty;
+	bool boxDirty;
+
+	// Marks the transformation matrix (and so the AABB too) as out of date.
+	void MarkDirty()
+	{
+		transformDirty = true;
+		boxDirty = true;
+	}
+
+	// If true, CalculateAABB transforms every vertex of the model to get the tightest possible box. Otherwise it transforms the model's local box, which is
+	// much faster but can be a little bigger than it needs to be for rotated models that aren't box shaped.
+	bool tightAABB;
+
+	void CalculateTightAABB();
+
+	// The ID the broadphase gave this object when it was registered, or -1 if it hasn't been registered.
+	int proxy;
+
+	// If this is set, the object's position, velocity and acceleration live in this store (at motionIndex) instead of in the members above, so that the world
+	// can integrate every object at once. The world doesn't tell us when it does that, so we remember the store's version from the last time we looked, and
+	// catch the translation matrix up the next time someone asks for the transform or the AABB.
+	MotionStore* motion;
+	int motionIndex;
+	unsigned int motionVersion;
+
+	void SyncMotion()
+	{
+		if (motion != nullptr && motionVersion != motion->GetVersion())
+		{
+			motionVersion = motion->GetVersion();
+
+			// A sleeping object hasn't moved, so there's no need to rebuild its matrices (or its AABB).
+			if (!asleep)
+			{
+				SetTranslation(GetPosition());
+			}
+		}
+	}
+
+	// A sleeping object has been sitting still for a while, so the world stops moving it, recalculating its AABB, and moving its broadphase proxy, until
+	// something bumps into it (or its position, velocity, rotation, etc. get changed from outside).
+	bool asleep;
+
+	// How many steps in a row the object has been moving slower than the world's sleep thresholds.
+	int restingSteps;
+
+	// How much the object has been rotated (in radians, added up over every call to Rotate) since the last sleep check.
+	float angularMotion;
+
 public:
 	GameObject(Model*);
 
@@ -100,49 +120,156 @@ public:
 	void Update(float);
 
 	AABB GetAABB()
+	{
+		SyncMotion();
+
+		if (boxDirty)
+		{
+			CalculateAABB();
+		}
+
+		return box;
+	}
+
+	// The AABB from the last time it was calculated, without checking whether it's out of date. Unlike GetAABB this never changes the object, so other
+	// threads can read it as long as nothing is recalculating it at the same time. (The world recalculates every box near the start of each step.)
+	const AABB& GetCachedAABB() const
 	{
 		return box;
 	}
 
 	void CalculateAABB();
 
+	bool GetTightAABB()
+	{
+		return tightAABB;
+	}
+	void SetTightAABB(bool tight)
+	{
+		tightAABB = tight;
+		boxDirty = true;
+	}
+
 	Model* GetModel()
 	{
 		return model;
 	}
+	int GetProxy()
+	{
+		return proxy;
+	}
+	void SetProxy(int id)
+	{
+		proxy = id;
+	}
+
+	// Moves the object's position, velocity and acceleration into the given store. From then on, the store is the only place they live.
+	void AttachMotion(MotionStore* store);
+
+	// Copies the position, velocity and acceleration back out of the store, so the object can live on its own again.
+	void DetachMotion();
+
+	bool IsAsleep()
+	{
+		return asleep;
+	}
+
+	// Wakes the object up (if it's asleep), and starts counting how long it has been resting over again.
+	void Wake();
+
+	// Puts the object to sleep right away, and stops it.
+	void Sleep();
+
+	// Called by the world once per step. Returns true if the object is asleep, or has been moving slower than linearThreshold (in units per second) and
+	// rotating slower than angularThreshold (in radians per second) for stepsToSleep steps in a row. The world puts it to sleep once everything in its
+	// island is ready to.
+	bool UpdateSleep(float dt, float linearThreshold, float angularThreshold, int stepsToSleep);
+
+	// The store moves objects around when one is removed, so the owner of the store has to tell us our new index.
+	void SetMotionIndex(int index)
+	{
+		motionIndex = index;
+	}
+	int GetMotionIndex()
+	{
+		return motionIndex;
+	}
 	glm::mat4* GetTransform()
 	{
+		SyncMotion();
+
+		if (transformDirty)
+		{
+			CalculateMatrices();
+		}
+
 		return &transformation;
 	}
 	glm::vec3 GetPosition()
 	{
-		return position;
+		return motion != nullptr ? motion->GetPosition(motionIndex) : position;
+	}
+	glm::mat4 GetRotation()
+	{
+		return rotation;
+	}
+	glm::vec3 GetScale()
+	{
+		// The scale matrix only has values along its diagonal.
+		return glm::vec3(scale[0][0], scale[1][1], scale[2][2]);
 	}
 	glm::vec3 GetVelocity()
 	{
-		return velocity;
+		return motion != nullptr ? motion->GetVelocity(motionIndex) : velocity;
 	}
 	glm::vec3 GetAcceleration()
 	{
-		return acceleration;
+		return motion != nullptr ? motion->GetAcceleration(motionIndex) : acceleration;
 	}
 
 	void AddPosition(glm::vec3);
 	void SetPosition(glm::vec3 pos)
 	{
-		position = pos;
+		Wake();
+
+		if (motion != nullptr)
+		{
+			motion->SetPosition(motionIndex, pos);
+		}
+		else
+		{
+			position = pos;
+		}
 
 		SetTranslation(pos);
 	}
 	void AddVelocity(glm::vec3);
 	void SetVelocity(glm::vec3 vel)
 	{
-		velocity = vel;
+		Wake();
+
+		if (motion != nullptr)
+		{
+			motion->SetVelocity(motionIndex, vel);
+		}
+		else
+		{
+			velocity = vel;
+		}
 	}
 	void AddAcceleration(glm::vec3);
 	void SetAcceleration(glm::vec3 accel)
 	{
-		acceleration = accel;
+		Wake();
+
+		if (motion != nullptr)
+		{
+			motion->SetAcceleration(motionIndex, accel);
+		}
+		else
+		{
+			acceleration = accel;
+		}
 	}
 
 	// Scales the current scale value by the x, y and z values given.
@@ -0,0 +1,134 @@
+/*
+Title: AABB-3D
+File Name: GameObjectPool.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _GAME_OBJECT_POOL_CPP
+#define _GAME_OBJECT_POOL_CPP
+
+#include "GameObjectPool.h"
+#include <new>
+
+GameObjectPool::GameObjectPool()
+{
+}
+
+GameObjectPool::~GameObjectPool()
+{
+	Clear();
+
+	for (size_t i = 0; i < slabs.size(); i++)
+	{
+		::operator delete(slabs[i]);
+	}
+}
+
+GameObjectHandle GameObjectPool::Create(Model* model)
+{
+	if (freeSlots.empty())
+	{
+		// Every slot is in use, so add another slab. Its slots go on the free list backwards, so that they get handed out in order.
+		slabs.push_back(static_cast<GameObject*>(::operator new(sizeof(GameObject) * SLAB_SIZE)));
+
+		int first = (int)slots.size();
+		Slot slot;
+		slot.generation = 1;
+		slot.dense = -1;
+		slots.resize(first + SLAB_SIZE, slot);
+
+		for (int i = first + SLAB_SIZE - 1; i >= first; i--)
+		{
+			freeSlots.push_back(i);
+		}
+	}
+
+	int slot = freeSlots.back();
+	freeSlots.pop_back();
+
+	// Build the object in place. (This is placement new, which runs the constructor on memory we already have instead of allocating more.)
+	GameObject* object = new (SlotObject(slot)) GameObject(model);
+
+	slots[slot].dense = (int)live.size();
+	live.push_back(object);
+	liveSlots.push_back(slot);
+
+	return GameObjectHandle(slot, slots[slot].generation);
+}
+
+bool GameObjectPool::Destroy(GameObjectHandle handle)
+{
+	if (!IsAlive(handle))
+	{
+		return false;
+	}
+
+	int slot = handle.index;
+	int dense = slots[slot].dense;
+
+	// Since the object was built with placement new, we call its destructor ourselves instead of using delete.
+	live[dense]->~GameObject();
+
+	// Move the last live object into the hole, so the list stays dense.
+	int last = (int)live.size() - 1;
+	live[dense] = live[last];
+	liveSlots[dense] = liveSlots[last];
+	slots[liveSlots[dense]].dense = dense;
+	live.pop_back();
+	liveSlots.pop_back();
+
+	// Bump the generation so any handles to the old object stop working. Zero is skipped, since that's what a default handle uses.
+	slots[slot].dense = -1;
+	slots[slot].generation++;
+	if (slots[slot].generation == 0)
+	{
+		slots[slot].generation = 1;
+	}
+
+	freeSlots.push_back(slot);
+
+	return true;
+}
+
+void GameObjectPool::Clear()
+{
+	while (!live.empty())
+	{
+		Destroy(GetHandle((int)live.size() - 1));
+	}
+}
+
+#endif // _GAME_OBJECT_POOL_CPP
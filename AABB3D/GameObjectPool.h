@@ -0,0 +1,165 @@
+/*
+Title: AABB-3D
+File Name: GameObjectPool.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _GAME_OBJECT_POOL_H
+#define _GAME_OBJECT_POOL_H
+
+#include "GameObject.h"
+#include <vector>
+
+// Refers to an object in a GameObjectPool. Unlike a pointer, a handle can tell when the object it points to has been destroyed: every slot in the pool has a
+// generation number that goes up each time the object in it is destroyed, and a handle only works while its generation matches the slot's.
+// A default constructed handle never refers to anything.
+struct GameObjectHandle
+{
+	unsigned int index;
+	unsigned int generation;
+
+	GameObjectHandle()
+	{
+		index = 0;
+		generation = 0;
+	}
+
+	GameObjectHandle(unsigned int i, unsigned int g)
+	{
+		index = i;
+		generation = g;
+	}
+
+	bool operator==(const GameObjectHandle& other) const
+	{
+		return index == other.index && generation == other.generation;
+	}
+	bool operator!=(const GameObjectHandle& other) const
+	{
+		return !(*this == other);
+	}
+};
+
+// Creates and destroys GameObjects without going to the heap for each one.
+// Objects are built in place inside big slabs of memory that hold SLAB_SIZE objects each. Destroyed slots go on a free list and get reused (newest first, so
+// the memory is likely still in the cache) by the next Create, so both Create and Destroy are O(1), and once the pool has grown to fit the busiest moment it
+// never allocates again. Slabs are never moved or freed until the pool is, so a pointer to a pooled object stays good for as long as the object is alive
+// (which matters, since the PhysicsWorld and the broadphase hold on to GameObject pointers).
+// The live objects are also kept in a dense list, so looping over them never has to skip over dead slots.
+// Remember to remove an object from the PhysicsWorld before destroying it!
+class GameObjectPool
+{
+	static const int SLAB_SIZE = 256;
+
+	struct Slot
+	{
+		// The generation of the object in this slot (or of the next one, if the slot is free).
+		unsigned int generation;
+
+		// Where this slot's object is in the dense list, or -1 if the slot is free.
+		int dense;
+	};
+
+	std::vector<GameObject*> slabs;
+	std::vector<Slot> slots;
+
+	// Indices of the free slots. The last one is reused first.
+	std::vector<int> freeSlots;
+
+	// The live objects, and the slot each one is in, in no particular order.
+	std::vector<GameObject*> live;
+	std::vector<int> liveSlots;
+
+	GameObject* SlotObject(int slot) const
+	{
+		return slabs[slot / SLAB_SIZE] + (slot % SLAB_SIZE);
+	}
+
+	// Copying would mean two pools destroying the same objects.
+	GameObjectPool(const GameObjectPool&);
+	GameObjectPool& operator=(const GameObjectPool&);
+
+public:
+	GameObjectPool();
+	~GameObjectPool();
+
+	// Builds a new GameObject using the given model, and returns a handle to it.
+	GameObjectHandle Create(Model* model);
+
+	// Destroys the object the handle refers to. Returns false (and does nothing) if the handle doesn't refer to a live object, so destroying the same object
+	// twice is harmless.
+	bool Destroy(GameObjectHandle handle);
+
+	// Destroys every object in the pool. The slabs are kept around to be reused.
+	void Clear();
+
+	// Returns the object the handle refers to, or nullptr if it has been destroyed.
+	GameObject* Get(GameObjectHandle handle) const
+	{
+		if (!IsAlive(handle))
+		{
+			return nullptr;
+		}
+
+		return SlotObject(handle.index);
+	}
+
+	bool IsAlive(GameObjectHandle handle) const
+	{
+		return handle.index < slots.size() && slots[handle.index].dense >= 0 && slots[handle.index].generation == handle.generation;
+	}
+
+	// The number of live objects.
+	int Size() const
+	{
+		return (int)live.size();
+	}
+
+	// Every live object, in no particular order. Destroying an object moves the last one in the list into its place.
+	const std::vector<GameObject*>& GetObjects() const
+	{
+		return live;
+	}
+
+	// The handle of the live object at the given index of GetObjects.
+	GameObjectHandle GetHandle(int i) const
+	{
+		int slot = liveSlots[i];
+		return GameObjectHandle(slot, slots[slot].generation);
+	}
+};
+
+#endif //_GAME_OBJECT_POOL_H
@@ -0,0 +1,155 @@
+/*
+Title: AABB-3D
+File Name: HeadlessMain.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+// This is the headless version of the demo. It runs the exact same physics as the windowed version, but with no window, no OpenGL, and no waiting around
+// for the physics step to come up. It just runs the requested number of steps as fast as it can and reports how fast that was.
+// This means it can run on machines with no graphics card at all (like build servers), which makes it handy for benchmarking.
+// Usage: AABB3DHeadless [number of objects] [number of steps] [trace file] [threads]
+// If a trace file is given, a Chrome trace of every physics phase is written to it (see Profiler.h). Pass "" to skip it and still give a number of threads.
+// The number of threads defaults to one per core. With 1, no job system is used at all and everything runs on the main thread.
+
+#include "Physics.h"
+#include "Scene.h"
+#include <iostream>
+#include <vector>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+// This is the number of seconds we intend for the physics to update, the same as in the windowed version.
+float physicsStep = 0.012f;
+
+int main(int argc, char **argv)
+{
+	int numObjects = 1000;
+	int numSteps = 10000;
+	std::string traceFile;
+	int numThreads = 0;
+
+	if (argc > 1)
+	{
+		numObjects = atoi(argv[1]);
+	}
+	if (argc > 2)
+	{
+		numSteps = atoi(argv[2]);
+	}
+	if (argc > 3)
+	{
+		traceFile = argv[3];
+	}
+	if (argc > 4)
+	{
+		numThreads = atoi(argv[4]);
+	}
+
+	if (numObjects < 1 || numSteps < 1)
+	{
+		std::cout << "Usage: " << argv[0] << " [number of objects] [number of steps] [trace file] [threads]" << std::endl;
+		return 1;
+	}
+
+	// Set up a scene full of moving cubes. Note that we never call InitBuffer on the model, since there's nothing to draw with.
+	Model* cube = CreateCubeModel();
+	PhysicsWorld world;
+	GameObjectPool pool;
+	std::vector<GameObjectHandle> objects;
+
+	SpawnCubes(world, pool, cube, numObjects, 1234, 0.9f, objects);
+
+	// Spread the per-object work across threads. The results are the same either way.
+	JobSystem* jobs = nullptr;
+	if (numThreads != 1)
+	{
+		jobs = new JobSystem(numThreads);
+		world.SetJobSystem(jobs);
+	}
+
+	// Time each phase of every step.
+	Profiler profiler;
+	world.SetProfiler(&profiler);
+
+	if (!traceFile.empty())
+	{
+		profiler.StartTrace();
+	}
+
+	// Run the steps back to back, timing the whole thing.
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+
+	for (int i = 0; i < numSteps; i++)
+	{
+		world.Step(physicsStep);
+	}
+
+	std::chrono::steady_clock::time_point end = std::chrono::steady_clock::now();
+	double seconds = std::chrono::duration<double>(end - start).count();
+
+	std::cout << "Objects: " << numObjects << std::endl;
+	std::cout << "Threads: " << (jobs != nullptr ? jobs->NumThreads() : 1) << std::endl;
+	std::cout << "Steps: " << numSteps << std::endl;
+	std::cout << "Seconds: " << seconds << std::endl;
+	std::cout << "Steps/sec: " << numSteps / seconds << std::endl;
+	std::cout << "Simulated seconds per real second: " << numSteps * physicsStep / seconds << std::endl;
+	std::cout << "Broadphase pairs in the last step: " << world.GetPairs().size() << std::endl;
+	std::cout << "Islands in the last step: " << world.GetIslands().NumIslands() << std::endl;
+	std::cout << std::endl;
+	profiler.Report(std::cout);
+
+	if (!traceFile.empty())
+	{
+		if (profiler.WriteTrace(traceFile))
+		{
+			std::cout << "Wrote trace to " << traceFile << std::endl;
+		}
+		else
+		{
+			std::cout << "Couldn't write trace to " << traceFile << std::endl;
+		}
+	}
+
+	// Cleanup your data!
+	world.Clear();
+	pool.Clear();
+
+	delete jobs;
+	delete cube;
+
+	return 0;
+}
@@ -0,0 +1,178 @@
+/*
+Title: AABB-3D
+File Name: IslandBuilder.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _ISLAND_BUILDER_CPP
+#define _ISLAND_BUILDER_CPP
+
+#include "IslandBuilder.h"
+#include <algorithm>
+
+IslandBuilder::IslandBuilder()
+{
+	numIslands = 0;
+	objectStart.push_back(0);
+	pairStart.push_back(0);
+}
+
+// Returns the root of the set that the object is in. On the way up, every other object is pointed at its grandparent (path halving), which keeps the trees
+// flat so that later calls are faster.
+int IslandBuilder::Find(int object)
+{
+	while (parent[object] != object)
+	{
+		parent[object] = parent[parent[object]];
+		object = parent[object];
+	}
+
+	return object;
+}
+
+// Merges the sets of the two objects. The smaller set is always hung under the bigger one, so that the trees stay shallow.
+void IslandBuilder::Union(int a, int b)
+{
+	int rootA = Find(a);
+	int rootB = Find(b);
+
+	if (rootA == rootB)
+	{
+		return;
+	}
+
+	if (setSize[rootA] < setSize[rootB])
+	{
+		std::swap(rootA, rootB);
+	}
+
+	parent[rootB] = rootA;
+	setSize[rootA] += setSize[rootB];
+}
+
+void IslandBuilder::Build(int numObjects, const std::vector<BroadphasePair>& pairs)
+{
+	parent.resize(numObjects);
+	setSize.resize(numObjects);
+
+	for (int i = 0; i < numObjects; i++)
+	{
+		parent[i] = i;
+		setSize[i] = 1;
+	}
+
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		Union(pairs[i].objectA->GetMotionIndex(), pairs[i].objectB->GetMotionIndex());
+	}
+
+	// Number the islands in the order their first object shows up, so the same pairs always give the same islands (no matter which root won each union).
+	objectIsland.resize(numObjects);
+	rootIsland.assign(numObjects, -1);
+	numIslands = 0;
+
+	for (int i = 0; i < numObjects; i++)
+	{
+		int root = Find(i);
+
+		if (rootIsland[root] < 0)
+		{
+			rootIsland[root] = numIslands++;
+		}
+
+		objectIsland[i] = rootIsland[root];
+	}
+
+	// Count how many objects are in each island, turn the counts into where each island starts, and then drop every object into place. Going through the
+	// objects in order means each island's objects come out in order too.
+	objectStart.assign(numIslands + 1, 0);
+
+	for (int i = 0; i < numObjects; i++)
+	{
+		objectStart[objectIsland[i] + 1]++;
+	}
+	for (int i = 0; i < numIslands; i++)
+	{
+		objectStart[i + 1] += objectStart[i];
+	}
+
+	islandObjects.resize(numObjects);
+	cursor.assign(objectStart.begin(), objectStart.end() - 1);
+
+	for (int i = 0; i < numObjects; i++)
+	{
+		islandObjects[cursor[objectIsland[i]]++] = i;
+	}
+
+	// Any pairs from an earlier AssignPairs don't mean anything for the new islands.
+	pairStart.assign(numIslands + 1, 0);
+	islandPairs.clear();
+	pairedIslands.clear();
+}
+
+void IslandBuilder::AssignPairs(const std::vector<BroadphasePair>& pairs)
+{
+	// The same counting sort as the objects in Build. (Both objects of a pair are in the same island, so we only need to look at one of them.)
+	pairStart.assign(numIslands + 1, 0);
+
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		pairStart[objectIsland[pairs[i].objectA->GetMotionIndex()] + 1]++;
+	}
+
+	pairedIslands.clear();
+
+	for (int i = 0; i < numIslands; i++)
+	{
+		if (pairStart[i + 1] > 0)
+		{
+			pairedIslands.push_back(i);
+		}
+
+		pairStart[i + 1] += pairStart[i];
+	}
+
+	islandPairs.resize(pairs.size());
+	cursor.assign(pairStart.begin(), pairStart.end() - 1);
+
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		int island = objectIsland[pairs[i].objectA->GetMotionIndex()];
+		islandPairs[cursor[island]++] = (int)i;
+	}
+}
+
+#endif // _ISLAND_BUILDER_CPP
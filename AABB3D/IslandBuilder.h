@@ -0,0 +1,131 @@
+/*
+Title: AABB-3D
+File Name: IslandBuilder.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _ISLAND_BUILDER_H
+#define _ISLAND_BUILDER_H
+
+#include "Broadphase.h"
+#include <vector>
+
+// Splits the objects in a world into islands: groups of objects that are (directly, or through other objects) touching each other.
+// Two objects end up in the same island if there is a chain of pairs connecting them (the world uses the pairs that collided this step), and an object that
+// isn't in any pair is an island all by itself. No collision links one island to another, so each island can have its collisions handled on a different
+// thread without any locks, and a whole island can be put to sleep at once (so that a pile of objects doesn't have half of it asleep while the other half
+// is still shifting around).
+// The islands are found with a union-find (also known as a disjoint set forest): every object starts out as its own set, each pair merges the sets of its
+// two objects, and at the end every object belongs to the same set as everything it is connected to. With path halving and union by size, this is very
+// close to O(objects + pairs).
+// Objects are referred to by their index in the world's objects list, which is also their motion index.
+class IslandBuilder
+{
+	// The union-find sets. An object that is its own parent is the root of its set, and setSize is only kept up to date for roots.
+	std::vector<int> parent;
+	std::vector<int> setSize;
+
+	// Which island each object is in, and which island each root ended up as (-1 if it isn't a root).
+	std::vector<int> objectIsland;
+	std::vector<int> rootIsland;
+
+	// The objects in each island, packed one island after another. The objects of island i are islandObjects[objectStart[i]] to
+	// islandObjects[objectStart[i + 1] - 1].
+	std::vector<int> objectStart;
+	std::vector<int> islandObjects;
+
+	// The same thing for the pairs handed to AssignPairs (as indices into that list), along with a list of just the islands that have any pairs at all.
+	std::vector<int> pairStart;
+	std::vector<int> islandPairs;
+	std::vector<int> pairedIslands;
+
+	// Where the next object (or pair) of each island goes while they're being sorted into place.
+	std::vector<int> cursor;
+
+	int numIslands;
+
+	int Find(int object);
+	void Union(int a, int b);
+
+public:
+	IslandBuilder();
+
+	// Finds the islands of numObjects objects, connected by the given pairs.
+	void Build(int numObjects, const std::vector<BroadphasePair>& pairs);
+
+	// Sorts a list of pairs (usually the ones that actually collided this step) into the islands found by the last Build. Every pair in the list has to
+	// connect two objects that were in the same island, which is always true for any subset of the pairs that Build was given.
+	// Within each island, the pairs stay in the same order they were in the list.
+	void AssignPairs(const std::vector<BroadphasePair>& pairs);
+
+	int NumIslands() const
+	{
+		return numIslands;
+	}
+
+	int GetIsland(int object) const
+	{
+		return objectIsland[object];
+	}
+
+	// The objects in the given island, in order of their index.
+	int IslandSize(int island) const
+	{
+		return objectStart[island + 1] - objectStart[island];
+	}
+	const int* IslandObjects(int island) const
+	{
+		return islandObjects.data() + objectStart[island];
+	}
+
+	// The pairs (from the last AssignPairs) in the given island.
+	int IslandPairCount(int island) const
+	{
+		return pairStart[island + 1] - pairStart[island];
+	}
+	const int* IslandPairs(int island) const
+	{
+		return islandPairs.data() + pairStart[island];
+	}
+
+	// The islands that had at least one pair in the last AssignPairs, in order.
+	const std::vector<int>& GetPairedIslands() const
+	{
+		return pairedIslands;
+	}
+};
+
+#endif //_ISLAND_BUILDER_H
@@ -0,0 +1,237 @@
+/*
+Title: AABB-3D
+File Name: JobSystem.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _JOB_SYSTEM_CPP
+#define _JOB_SYSTEM_CPP
+
+#include "JobSystem.h"
+
+// Which job system (if any) the current thread is working for, and which of its queues belongs to this thread.
+static thread_local JobSystem* currentSystem = nullptr;
+static thread_local int currentQueue = 0;
+
+JobSystem::JobSystem(int numThreads)
+{
+	if (numThreads <= 0)
+	{
+		numThreads = (int)std::thread::hardware_concurrency();
+	}
+	if (numThreads < 1)
+	{
+		numThreads = 1;
+	}
+
+	pending = 0;
+	stopping = false;
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		queues.push_back(new WorkQueue());
+	}
+
+	for (int i = 1; i < numThreads; i++)
+	{
+		workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+	}
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	wake.notify_all();
+
+	for (size_t i = 0; i < workers.size(); i++)
+	{
+		workers[i].join();
+	}
+
+	for (size_t i = 0; i < queues.size(); i++)
+	{
+		delete queues[i];
+	}
+}
+
+void JobSystem::WorkerLoop(int index)
+{
+	currentSystem = this;
+	currentQueue = index;
+
+	while (!stopping)
+	{
+		if (!RunOne(index))
+		{
+			// Nothing to do anywhere, so sleep until someone hands out more work.
+			std::unique_lock<std::mutex> lock(sleepMutex);
+			wake.wait(lock, [this]() { return pending > 0 || stopping; });
+		}
+	}
+}
+
+bool JobSystem::RunOne(int index)
+{
+	Job job;
+	bool found = false;
+	int numQueues = (int)queues.size();
+
+	// Our own queue first, newest job first. The newest job is the one most likely to still have its data in this core's cache.
+	{
+		WorkQueue* queue = queues[index];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+
+		if (!queue->jobs.empty())
+		{
+			job = queue->jobs.back();
+			queue->jobs.pop_back();
+			found = true;
+		}
+	}
+
+	// Then steal the oldest job from someone else. Taking from the other end means we rarely get in the way of the thread that owns the queue.
+	for (int i = 1; i < numQueues && !found; i++)
+	{
+		WorkQueue* queue = queues[(index + i) % numQueues];
+		std::lock_guard<std::mutex> lock(queue->mutex);
+
+		if (!queue->jobs.empty())
+		{
+			job = queue->jobs.front();
+			queue->jobs.pop_front();
+			found = true;
+		}
+	}
+
+	if (!found)
+	{
+		return false;
+	}
+
+	pending--;
+	job.function();
+	job.counter->fetch_sub(1);
+
+	return true;
+}
+
+void JobSystem::Wait(int index, std::atomic<int>& counter)
+{
+	// Rather than sit idle, help out with whatever jobs there are (ours or anyone's) until ours are done.
+	while (counter > 0)
+	{
+		if (!RunOne(index))
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+void JobSystem::Submit(int index, int numChunks, int count, int grainSize, const std::function<void(int, int)>& body, std::atomic<int>& counter)
+{
+	WorkQueue* queue = queues[index];
+
+	{
+		std::lock_guard<std::mutex> lock(queue->mutex);
+
+		for (int i = 0; i < numChunks; i++)
+		{
+			int begin = i * grainSize;
+			int end = begin + grainSize < count ? begin + grainSize : count;
+
+			Job job;
+			job.function = [&body, begin, end]() { body(begin, end); };
+			job.counter = &counter;
+			queue->jobs.push_back(job);
+		}
+	}
+
+	// Hold the sleep lock while bumping the count, so that a worker can't check it and then miss the wake up.
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		pending += numChunks;
+	}
+	wake.notify_all();
+}
+
+void JobSystem::ParallelFor(int count, int grainSize, const std::function<void(int, int)>& body)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+	if (grainSize < 1)
+	{
+		grainSize = 1;
+	}
+
+	int numChunks = (count + grainSize - 1) / grainSize;
+
+	// Not worth handing out if there's only one chunk, or no one to hand it to.
+	if (numChunks == 1 || workers.empty())
+	{
+		body(0, count);
+		return;
+	}
+
+	std::atomic<int> counter(numChunks);
+
+	if (currentSystem == this)
+	{
+		// We're already one of this system's threads (a worker, or an outside thread that's inside a ParallelFor), so we can use our own queue.
+		Submit(currentQueue, numChunks, count, grainSize, body, counter);
+		Wait(currentQueue, counter);
+		return;
+	}
+
+	// An outside thread. Take queue 0, and mark this thread as ours until we're done, so that a ParallelFor inside the body uses queue 0 too.
+	std::lock_guard<std::mutex> lock(submitMutex);
+	JobSystem* previousSystem = currentSystem;
+	int previousQueue = currentQueue;
+	currentSystem = this;
+	currentQueue = 0;
+
+	Submit(0, numChunks, count, grainSize, body, counter);
+	Wait(0, counter);
+
+	currentSystem = previousSystem;
+	currentQueue = previousQueue;
+}
+
+#endif // _JOB_SYSTEM_CPP
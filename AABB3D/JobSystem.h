@@ -0,0 +1,131 @@
+/*
+Title: AABB-3D
+File Name: JobSystem.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _JOB_SYSTEM_H
+#define _JOB_SYSTEM_H
+
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+
+// Spreads work across every core of the CPU.
+// There is one worker thread per core (minus one, since the thread that asks for the work helps out too). Each thread has its own queue of jobs. A thread
+// takes jobs off the back of its own queue, and when that runs dry it steals jobs off the front of someone else's. This is called work stealing. It keeps
+// every thread busy without them all fighting over a single shared queue, and it evens out on its own when some jobs take longer than others.
+// The main way to use it is ParallelFor, which splits a range of indices into chunks and runs the chunks as jobs.
+class JobSystem
+{
+	struct Job
+	{
+		std::function<void()> function;
+
+		// Counted down when the job finishes, so whoever started the job knows when it's done.
+		std::atomic<int>* counter;
+	};
+
+	struct WorkQueue
+	{
+		std::mutex mutex;
+		std::deque<Job> jobs;
+	};
+
+	std::vector<std::thread> workers;
+
+	// Queue 0 belongs to whichever outside thread is calling ParallelFor. Queue i belongs to worker i.
+	std::vector<WorkQueue*> queues;
+
+	// Only one outside thread can hand out work at a time, since they all share queue 0.
+	std::mutex submitMutex;
+
+	// The number of jobs sitting in queues. Workers with nothing to do sleep until this goes above zero.
+	std::atomic<int> pending;
+	std::mutex sleepMutex;
+	std::condition_variable wake;
+
+	std::atomic<bool> stopping;
+
+	void WorkerLoop(int index);
+
+	// Finds one job (from the given queue first, then by stealing) and runs it. Returns false if there was nothing to run.
+	bool RunOne(int index);
+
+	// Runs jobs until the counter reaches zero.
+	void Wait(int index, std::atomic<int>& counter);
+
+	void Submit(int index, int numChunks, int count, int grainSize, const std::function<void(int, int)>& body, std::atomic<int>& counter);
+
+	JobSystem(const JobSystem&);
+	JobSystem& operator=(const JobSystem&);
+
+public:
+	// Starts numThreads - 1 worker threads. If numThreads is 0, one thread per core is used.
+	JobSystem(int numThreads = 0);
+	~JobSystem();
+
+	// The number of threads that work on a ParallelFor, counting the one that called it.
+	int NumThreads() const
+	{
+		return (int)workers.size() + 1;
+	}
+
+	// Calls body(begin, end) over chunks of grainSize indices that together cover 0 to count, spread over every thread, and returns once they have all
+	// finished. The calling thread runs chunks too while it waits. It is fine to call ParallelFor again from inside the body.
+	// The chunks only depend on count and grainSize (not on the number of threads or which thread runs what), so as long as the body only writes to things
+	// that belong to its own indices, the results are exactly the same as running body(0, count) on one thread.
+	void ParallelFor(int count, int grainSize, const std::function<void(int, int)>& body);
+};
+
+// Runs body over 0 to count on the given job system, or just calls body(0, count) right here if there isn't one.
+inline void ParallelFor(JobSystem* jobs, int count, int grainSize, const std::function<void(int, int)>& body)
+{
+	if (jobs != nullptr)
+	{
+		jobs->ParallelFor(count, grainSize, body);
+	}
+	else if (count > 0)
+	{
+		body(0, count);
+	}
+}
+
+#endif //_JOB_SYSTEM_H
@@ -45,147 +45,59 @@ simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
 #include <vector>
 #include <string>
 #include <algorithm>
+#include <cstdio>
 
 
-// Variables for FPS and Physics Timestep calculations.
-int frame = 0;
+// Variables for showing the profiler's timings once a second.
 double time = 0;
-double timebase = 0;
-double accumulator = 0.0;
-int fps = 0;
-double FPSTime = 0.0;
-double physicsStep = 0.012; // This is the number of milliseconds we intend for the physics to update.
-
-
-bool antiStuck = false;
+double reportTime = 0.0;
 
 // Reference to the window object being created by GLFW.
 GLFWwindow* window;
 
-// Regular AABB collision detection. (Not used in this demo, but should work just fine.)
-bool TestAABB(AABB a, AABB b)
-{
-	// If any axis is separated, exit with no intersection.
-	if (a.max.x < b.min.x || a.min.x > b.max.x) return false;
-	if (a.max.y < b.min.y || a.min.y > b.max.y) return false;
-	if (a.max.z < b.min.z || a.min.z > b.max.z) return false;
-
-	return true;
-}
-
-// This runs once every physics timestep.
+// This runs once every physics timestep, on the physics thread.
 void update(float dt)
 {
-	// This section just checks to make sure the object stays within a certain boundary. This is not really collision detection.
-	glm::vec3 tempPos = obj2->GetPosition();
-
-	if (fabsf(tempPos.x) > 0.9f)
-	{
-		glm::vec3 tempVel = obj2->GetVelocity();
-
-		// "Bounce" the velocity along the axis that was over-extended.
-		obj2->SetVelocity(glm::vec3(-1.0f * tempVel.x, tempVel.y, tempVel.z));
-	}
-	if (fabsf(tempPos.y) > 0.8f)
-	{
-		glm::vec3 tempVel = obj2->GetVelocity();
-		obj2->SetVelocity(glm::vec3(tempVel.x, -1.0f * tempVel.y, tempVel.z));
-	}
-	if (fabsf(tempPos.z) > 1.0f)
-	{
-		glm::vec3 tempVel = obj2->GetVelocity();
-		obj2->SetVelocity(glm::vec3(tempVel.x, tempVel.y, -1.0f * tempVel.z));
-	}
-
 	// Rotate the objects. This helps illustrate how the AABB recalculates as an object's orientation changes.
-	obj1->Rotate(glm::vec3(glm::radians(1.0f), glm::radians(1.0f), glm::radians(0.0f)));
-	obj2->Rotate(glm::vec3(glm::radians(1.0f), glm::radians(1.0f), glm::radians(0.0f)));
-
-	// Re-calculate the Axis-Aligned Bounding Box for your object.
-	// We do this because if the object's orientation changes, we should update the bounding box as well.
-	// Be warned: For some objects this can actually cause a collision to be missed, so be careful.
-	// (This is because we determine the time of the collision based on the AABB, but if the AABB changes significantly, the time of collision can change between frames,
-	// and if that lines up just right you'll miss the collision altogether.)
-	obj1->CalculateAABB();
-	obj2->CalculateAABB();
-
-	if (TestAABB(obj1->GetAABB(), obj2->GetAABB()) && !antiStuck)
-	{
-		// Create a local velocity variable based off of the moving object's velocity.
-		glm::vec3 velocity = obj2->GetVelocity();
+	// Each object only rotates itself, so this can be spread across the world's job system.
+	std::vector<GameObject*>& objects = world.GetObjects();
 
-		// Reverse the velocity in the x direction
-		// This is the "bounce" effect, only we don't actually know the axis of collision from the test. Instead, we assume it because the object is only moving in the x 
-		// direction.
-		velocity.x *= -1;
-
-		obj2->SetVelocity(velocity);
-
-		// This variable exists to help prevent the object from getting stuck inside the other object due to tunneling or recalculating of the AABB. It is not, however, 
-		// a perfect solution and the object can still get stuck. A way of preventing is this is called Sweeping collision detection, and we have examples of it listed 
-		// as Swept AABB.
-		antiStuck = true;
-	}
-	else
+	ParallelFor(world.GetJobSystem(), (int)objects.size(), 512, [&objects](int begin, int end)
 	{
-		antiStuck = false;
-	}
-
-	obj1->Update(dt);
-	obj2->Update(dt);
+		for (int i = begin; i < end; i++)
+		{
+			objects[i]->Rotate(glm::vec3(glm::radians(1.0f), glm::radians(1.0f), glm::radians(0.0f)));
+		}
+	});
 
-	// Update your MVP matrices based on the objects' transforms.
-	MVP = PV * *obj1->GetTransform();
-	MVP2 = PV * *obj2->GetTransform();
+	// Run the physics step. This keeps the objects inside the walls, recalculates the AABBs, finds and responds to collisions, and moves everything.
+	world.Step(dt);
 }
 
-// This runs once every frame to determine the FPS and how often to call update based on the physics step.
+// This runs once every frame, and once a second shows the profiler's timings. (The physics thread decides for itself when to call update.)
 void checkTime()
 {
 	// Get the current time.
 	time = glfwGetTime();
 
-	// Get the time since we last ran an update.
-	double dt = time - timebase;
-
-	// If more time has passed than our physics timestep.
-	if (dt > physicsStep)
+	if (time - reportTime > 1.0)
 	{
-		// Calculate FPS: Take the number of frames (frame) since the last time we calculated FPS, and divide by the amount of time that has passed since the 
-		// last time we calculated FPS (time - FPSTime).
-		if (time - FPSTime > 1.0)
-		{
-			fps = frame / (time - FPSTime);
-
-			FPSTime = time; // Now we set FPSTime = time, so that we have a reference for when we calculated the FPS
-
-			frame = 0; // Reset our frame counter to 0, to mark that 0 frames have passed since we calculated FPS (since we literally just did it)
-
-			std::string s = "FPS: " + std::to_string(fps); // This just creates a string that looks like "FPS: 60" or however much.
-
-			glfwSetWindowTitle(window, s.c_str()); // This will set the window title to that string, displaying the FPS as the window title.
-		}
-
-		timebase = time; // Set timebase = time so we have a reference for when we ran the last physics timestep.
-
-						 // Limit dt so that we if we experience any sort of delay in processing power or the window is resizing/moving or anything, it doesn't update a bunch of times while the player can't see.
-						 // This will limit it to a .25 seconds.
-		if (dt > 0.25)
-		{
-			dt = 0.25;
-		}
-
-		// The accumulator is here so that we can track the amount of time that needs to be updated based on dt, but not actually update at dt intervals and instead use our physicsStep.
-		accumulator += dt;
-
-		// Run a while loop, that runs update(physicsStep) until the accumulator no longer has any time left in it (or the time left is less than physicsStep, at which point it save that 
-		// leftover time and use it in the next checkTime() call.
-		while (accumulator >= physicsStep)
-		{
-			update(physicsStep);
-
-			accumulator -= physicsStep;
-		}
+		reportTime = time; // Now we set reportTime = time, so that we have a reference for when we last showed the timings.
+
+		// An FPS counter only tells you the average. The percentiles tell you about the slow frames too: if the p99 is much higher than the p50, then
+		// roughly one frame (or step) in every hundred is a spike.
+		ProfileStats frameStats = profiler.GetStats(PROFILE_FRAME);
+		ProfileStats stepStats = profiler.GetStats(PROFILE_STEP);
+
+		// If the physics can't keep up with real time, it drops the time it can't catch up on, so that shows up here too.
+		char title[160];
+		snprintf(title, sizeof(title), "Frame p50 %.2f ms p99 %.2f ms | Step p50 %.3f ms p99 %.3f ms | Dropped %.2f s", frameStats.p50, frameStats.p99,
+			stepStats.p50, stepStats.p99, physicsThread.GetDroppedTime());
+		glfwSetWindowTitle(window, title);
+
+		// The full breakdown of every phase goes to the console.
+		profiler.Report(std::cout);
+		std::cout << std::endl;
 	}
 }
 
@@ -210,10 +122,17 @@ int main(int argc, char **argv)
 	// Initializes most things needed before the main loop
 	init();
 
+	// Start running the physics on its own thread. It calls update once every physics step, and accumulates the time between steps itself. It only runs a few
+	// steps at a time, so that if we experience any sort of delay in processing power, it catches back up over the next few frames instead of all at once.
+	physicsThread.Start(update);
+
 	// Enter the main loop.
 	while (!glfwWindowShouldClose(window))
 	{
-		// Call to checkTime() which will determine how to go about updating via a set physics timestep as well as calculating FPS.
+		// Times this whole frame, from here to the end of the loop.
+		ScopedTimer frameTimer(&profiler, PROFILE_FRAME);
+
+		// Call to checkTime() which will show the profiler's timings.
 		checkTime();
 
 		// Call the render function.
@@ -223,9 +142,6 @@ int main(int argc, char **argv)
 		// Remember, you're rendering to the back buffer, then once rendering is complete, you're moving the back buffer to the front so it can be displayed.
 		glfwSwapBuffers(window);
 
-		// Add one to our frame counter, since we've successfully 
-		frame++;
-
 		// Checks to see if any events are pending and then processes them.
 		glfwPollEvents();
 	}
@@ -41,12 +41,32 @@ simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
 #define _MODEL_CPP
 
 #include "Model.h"
+#include <cstdlib>
+#include <cstring>
+#include <vector>
 
 // Creates a new model with a given vertices and indices.
 // If no vertices are passed in (numVerts = 0) then it will skip initialization completely.
 // If no indices are passed in (numInds = 0) but vertices are, it will set the indices equal to the vertices in order. (So just 0, 1, 2, 3, 4, etc.)
-Model::Model(int numVerts, VertexFormat* verts, int numInds, GLuint* inds)
+Model::Model(int numVerts, VertexFormat* verts, int numInds, unsigned int* inds)
 {
+	// Start out empty, in case no vertices were passed in.
+	numVertices = 0;
+	vertices = nullptr;
+	numIndices = 0;
+	indices = nullptr;
+	vertexCapacity = 0;
+	indexCapacity = 0;
+	vbo = 0;
+	ebo = 0;
+	vao = 0;
+	instanceVbo = 0;
+	instanceCapacity = 0;
+	dirty = false;
+	positionX = positionY = positionZ = nullptr;
+	positionCapacity = 0;
+	jobs = nullptr;
+
 	if (numVerts > 0)
 	{
 		// Allocate space for the size of the vertices array.
@@ -57,22 +77,24 @@ Model::Model(int numVerts, VertexFormat* verts, int numInds, GLuint* inds)
 
 		// Set the numVertices equal to the passed in numVerts.
 		numVertices = numVerts;
+		vertexCapacity = numVerts;
 
 		if (numInds > 0)
 		{
 			// Allocate space for the size of the indices array.
-			indices = (GLuint*)malloc(sizeof(GLuint) * numInds);
+			indices = (unsigned int*)malloc(sizeof(unsigned int) * numInds);
 
 			// Copy the data from the passed in inds to the indices array.
-			memcpy(indices, inds, sizeof(GLuint) * numInds);
+			memcpy(indices, inds, sizeof(unsigned int) * numInds);
 
 			// Set the numIndices equal tot he passed in numInds.
 			numIndices = numInds;
+			indexCapacity = numInds;
 		}
 		else
 		{
 			// Allocate space for enough indices to have one index per vertex.
-			indices = (GLuint*)malloc(sizeof(GLuint) * numVerts);
+			indices = (unsigned int*)malloc(sizeof(unsigned int) * numVerts);
 
 			// Loop through and set each index to be in sequential order. (0, 1, 2, 3, 4, etc.)
 			for (int i = 0; i < numVerts; i++)
@@ -82,11 +104,18 @@ Model::Model(int numVerts, VertexFormat* verts, int numInds, GLuint* inds)
 
 			// Set the numIndices equal to the number of vertices.
 			numIndices = numVerts;
+			indexCapacity = numVerts;
 		}
 
-		// Initialize the buffer.
-		InitBuffer();
+		// Work out the model space bounding box once, up front.
+		CalculateLocalAABB();
+		StreamPositions(0);
+
+		// None of this data is on the GPU yet.
+		dirty = true;
 	}
+
+	// Note that we don't create the GPU buffers here. Call InitBuffer once OpenGL has been initialized if you want to draw this model.
 }
 
 Model::~Model()
@@ -94,186 +123,326 @@ Model::~Model()
 	// Free up any remaining data.
 	free(vertices);
 	free(indices);
+	AlignedFree(positionX);
+	AlignedFree(positionY);
+	AlignedFree(positionZ);
 
 	numVertices = 0;
 	numIndices = 0;
+	vertexCapacity = 0;
+	indexCapacity = 0;
 
-	glDeleteBuffers(1, &vbo);
-	glDeleteBuffers(1, &ebo);
+	// The GPU buffers (if there are any) have to be released with ReleaseBuffer before the OpenGL context goes away.
 }
 
-void Model::InitBuffer()
+// Finds the smallest box (in model space) that contains every vertex.
+void Model::CalculateLocalAABB()
 {
-	// This generates buffer object names
-	// The first parameter is the number of buffer objects, and the second parameter is a pointer to an array of buffer objects (yes, before this call, vbo was an empty variable)
-	// (In this example, there's only one buffer object.)
-	glGenBuffers(1, &vbo);
-	glGenBuffers(1, &ebo);
-
-	//// Binds a named buffer object to the specified buffer binding point. Give it a target (GL_ARRAY_BUFFER) to determine where to bind the buffer.
-	//// There are several different target parameters, GL_ARRAY_BUFFER is for vertex attributes, feel free to Google the others to find out what else there is.
-	//// The second paramter is the buffer object reference. If no buffer object with the given name exists, it will create one.
-	//// Buffer object names are unsigned integers (like vbo). Zero is a reserved value, and there is no default buffer for each target (targets, like GL_ARRAY_BUFFER).
-	//// Passing in zero as the buffer name (second parameter) will result in unbinding any buffer bound to that target, and frees up the memory.
-	glBindBuffer(GL_ARRAY_BUFFER, vbo);
-
-	//// GL_ELEMENT_ARRAY_BUFFER is for vertex array indices, all drawing commands of glDrawElements will use indices from that buffer.
-	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
-
-	//// Creates and initializes a buffer object's data.
-	//// First parameter is the target, second parameter is the size of the buffer, third parameter is a pointer to the data that will copied into the buffer, and fourth parameter is the 
-	//// expected usage pattern of the data. Possible usage patterns: GL_STREAM_DRAW, GL_STREAM_READ, GL_STREAM_COPY, GL_STATIC_DRAW, GL_STATIC_READ, GL_STATIC_COPY, GL_DYNAMIC_DRAW, 
-	//// GL_DYNAMIC_READ, or GL_DYNAMIC_COPY
-	//// Stream means that the data will be modified once, and used only a few times at most. Static means that the data will be modified once, and used a lot. Dynamic means that the data 
-	//// will be modified repeatedly, and used a lot. Draw means that the data is modified by the application, and used as a source for GL drawing. Read means the data is modified by 
-	//// reading data from GL, and used to return that data when queried by the application. Copy means that the data is modified by reading from the GL, and used as a source for drawing.
-	glBufferData(GL_ARRAY_BUFFER, sizeof(VertexFormat) * numVertices, vertices, GL_STATIC_DRAW);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * numIndices, indices, GL_STATIC_DRAW);
-
-	//// By default, all client-side capabilities are disabled, including all generic vertex attribute arrays.
-	//// When enabled, the values in a generic vertex attribute array will be accessed and used for rendering when calls are made to vertex array commands (like glDrawArrays/glDrawElements)
-	//// A GL_INVALID_VALUE will be generated if the index parameter is greater than or equal to GL_MAX_VERTEX_ATTRIBS
-	glEnableVertexAttribArray(0);
-
-	//// Defines an array of generic vertex attribute data. Takes an index, a size specifying the number of components (in this case, floats)(has a max of 4)
-	//// The third parameter, type, can be GL_BYTE, GL_UNSIGNED_BYTE, GL_SHORT, GL_UNSIGNED_SHORT, GL_FIXED, or GL_FLOAT
-	//// The fourth parameter specifies whether to normalize fixed-point data values, the fifth parameter is the stride which is the offset (in bytes) between generic vertex attributes
-	//// The fifth parameter is a pointer to the first component of the first generic vertex attribute in the array. If a named buffer object is bound to GL_ARRAY_BUFFER (and it is, in this case) 
-	//// then the pointer parameter is treated as a byte offset into the buffer object's data.
-	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)16);
-	//// You'll note sizeof(VertexFormat) is our stride, because each vertex contains data that adds up to that size.
-	//// You'll also notice we offset this parameter by 16 bytes, this is because the vec3 position attribute is after the vec4 color attribute. A vec4 has 4 floats, each being 4 bytes 
-	//// so we offset by 4*4=16 to make sure that our first attribute is actually the position. The reason we put position after color in the struct has to do with padding.
-	//// For more info on padding, Google it.
-
-	//// This is our color attribute, so the offset is 0, and the size is 4 since there are 4 floats for color.
-	glEnableVertexAttribArray(1);
-	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)0);
+	if (numVertices <= 0)
+	{
+		localBox = AABB();
+		return;
+	}
+
+	GrowLocalAABB(0);
 }
 
-void Model::UpdateBuffer()
+// Works out how big an array needs to be to hold at least required elements, starting from its current capacity.
+// Doubling (rather than growing by a fixed amount) means that every element only gets copied a couple of times on average, no matter how big the array gets.
+static int GrowCapacity(int capacity, int required)
 {
-	//// Creates and initializes a buffer object's data.
-	//// First parameter is the target, second parameter is the size of the buffer, third parameter is a pointer to the data that will copied into the buffer, and fourth parameter is the 
-	//// expected usage pattern of the data. Possible usage patterns: GL_STREAM_DRAW, GL_STREAM_READ, GL_STREAM_COPY, GL_STATIC_DRAW, GL_STATIC_READ, GL_STATIC_COPY, GL_DYNAMIC_DRAW, 
-	//// GL_DYNAMIC_READ, or GL_DYNAMIC_COPY
-	//// Stream means that the data will be modified once, and used only a few times at most. Static means that the data will be modified once, and used a lot. Dynamic means that the data 
-	//// will be modified repeatedly, and used a lot. Draw means that the data is modified by the application, and used as a source for GL drawing. Read means the data is modified by 
-	//// reading data from GL, and used to return that data when queried by the application. Copy means that the data is modified by reading from the GL, and used as a source for drawing.
-	glBufferData(GL_ARRAY_BUFFER, sizeof(VertexFormat) * numVertices, vertices, GL_STATIC_DRAW);
-	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * numIndices, indices, GL_STATIC_DRAW);
+	if (capacity < 16)
+	{
+		capacity = 16;
+	}
+
+	while (capacity < required)
+	{
+		capacity *= 2;
+	}
+
+	return capacity;
 }
 
-void Model::Draw()
+void Model::Reserve(int vertexCount, int indexCount)
 {
-	// Draw vertices from the buffer as GL_TRIANGLES
-	// There are several different drawing modes, GL_TRIANGLES takes every 3 vertices and makes them a triangle.
-	// For reference, GL_TRIANGLE_STRIP would take each additional vertex after the first 3 and consider that a 
-	// triangle with the previous 2 vertices (so you could make 2 triangles with 4 vertices)
-	// The second parameter is the offset, the third parameter is the number of vertices to draw.
-	//glDrawArrays(GL_TRIANGLES, 0, numVertices);
+	if (vertexCount > vertexCapacity)
+	{
+		// realloc keeps the existing data, and can often just extend the block in place instead of copying it.
+		vertices = (VertexFormat*)realloc(vertices, sizeof(VertexFormat) * vertexCount);
+		vertexCapacity = vertexCount;
+	}
 
+	if (indexCount > indexCapacity)
+	{
+		indices = (unsigned int*)realloc(indices, sizeof(unsigned int) * indexCount);
+		indexCapacity = indexCount;
+	}
+}
 
+// Grows the local bounding box to fit every vertex from first onwards.
+void Model::GrowLocalAABB(int first)
+{
+	if (first == 0)
+	{
+		// The model was empty, so the box starts out as just the first vertex.
+		localBox = AABB(vertices[0].position, vertices[0].position);
+		first = 1;
+	}
 
-	// Draw numIndices vertices from the buffer as GL_TRIANGLES
-	// There are several different drawing modes, GL_TRIANGLES takes every 3 vertices and makes them a triangle.
-	// For reference, GL_TRIANGLE_STRIP would take each additional vertex after the first 3 and consider that a 
-	// triangle with the previous 2 vertices (so you could make 2 triangles with 4 vertices)
-	// The second parameter is the number of vertices, the third parameter is the type of the element buffer data, and the fourth parameter is the offset.
-	glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0);
+	for (int i = first; i < numVertices; i++)
+	{
+		localBox.min = glm::min(localBox.min, vertices[i].position);
+		localBox.max = glm::max(localBox.max, vertices[i].position);
+	}
 }
 
-GLuint Model::AddVertex(VertexFormat* vert)
+void Model::StreamPositions(int first)
 {
-	if (numVertices > 0)
+	// Room for every vertex, rounded up to a whole block of 8.
+	int padded = (numVertices + 7) & ~7;
+
+	if (padded > positionCapacity)
 	{
-		// Allocate space equivalent to our current vertices array.
-		VertexFormat* tempVerts = (VertexFormat*)malloc(sizeof(VertexFormat) * numVertices);
-		
-		// Copy our current vertices array into our temporary array.
-		memcpy(tempVerts, vertices, numVertices);
+		int newCapacity = (GrowCapacity(positionCapacity, padded) + 7) & ~7;
+		float** arrays[3] = { &positionX, &positionY, &positionZ };
 
-		// Increase the number of vertices count by 1.
-		numVertices++;
+		for (int a = 0; a < 3; a++)
+		{
+			float* newArray = AlignedAlloc(newCapacity);
 
-		// Free the vertices array.
-		free(vertices);
+			if (*arrays[a] != nullptr)
+			{
+				memcpy(newArray, *arrays[a], sizeof(float) * first);
+				AlignedFree(*arrays[a]);
+			}
 
-		// Allocate space equivalent to our new vertices size.
-		vertices = (VertexFormat*)malloc(sizeof(VertexFormat) * numVertices);
+			*arrays[a] = newArray;
+		}
 
-		// Copy the data from the temporary array back into the vertices array.
-		memcpy(vertices, tempVerts, numVertices - 1);
+		positionCapacity = newCapacity;
+	}
 
-		// Free the temporary array.
-		free(tempVerts);
+	for (int i = first; i < numVertices; i++)
+	{
+		positionX[i] = vertices[i].position.x;
+		positionY[i] = vertices[i].position.y;
+		positionZ[i] = vertices[i].position.z;
+	}
 
-		// Set the last value in the vertices array to the new vertex.
-		vertices[numVertices - 1] = *vert;
+	// Fill the padding with the first position, so that it can't make the bounds any bigger.
+	for (int i = numVertices; i < padded; i++)
+	{
+		positionX[i] = vertices[0].position.x;
+		positionY[i] = vertices[0].position.y;
+		positionZ[i] = vertices[0].position.z;
+	}
+}
 
-		// Update our buffer to match this change.
-		UpdateBuffer();
+// Transforms the positions from begin up to end (both multiples of 8) by the matrix, and grows the given min and max to fit them.
+// Each result is added up in the same order glm uses for a matrix times a vec4 ((x column + y column) + (z column + translation)), so the box comes out
+// exactly the same as transforming each vertex with glm would give.
+static void TransformedBounds(const glm::mat4& m, const float* x, const float* y, const float* z, int begin, int end, glm::vec3& boxMin, glm::vec3& boxMax)
+{
+	int i = begin;
+
+#if defined(PHYSICS_AVX)
+	__m256 m00 = _mm256_set1_ps(m[0][0]), m01 = _mm256_set1_ps(m[0][1]), m02 = _mm256_set1_ps(m[0][2]);
+	__m256 m10 = _mm256_set1_ps(m[1][0]), m11 = _mm256_set1_ps(m[1][1]), m12 = _mm256_set1_ps(m[1][2]);
+	__m256 m20 = _mm256_set1_ps(m[2][0]), m21 = _mm256_set1_ps(m[2][1]), m22 = _mm256_set1_ps(m[2][2]);
+	__m256 m30 = _mm256_set1_ps(m[3][0]), m31 = _mm256_set1_ps(m[3][1]), m32 = _mm256_set1_ps(m[3][2]);
 
-		// Return the index reference to this vertex.
-		return numVertices - 1;
+	__m256 minX = _mm256_set1_ps(boxMin.x), minY = _mm256_set1_ps(boxMin.y), minZ = _mm256_set1_ps(boxMin.z);
+	__m256 maxX = _mm256_set1_ps(boxMax.x), maxY = _mm256_set1_ps(boxMax.y), maxZ = _mm256_set1_ps(boxMax.z);
+
+	for (; i < end; i += 8)
+	{
+		__m256 vx = _mm256_load_ps(x + i);
+		__m256 vy = _mm256_load_ps(y + i);
+		__m256 vz = _mm256_load_ps(z + i);
+
+		__m256 tx = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m00, vx), _mm256_mul_ps(m10, vy)), _mm256_add_ps(_mm256_mul_ps(m20, vz), m30));
+		__m256 ty = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m01, vx), _mm256_mul_ps(m11, vy)), _mm256_add_ps(_mm256_mul_ps(m21, vz), m31));
+		__m256 tz = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(m02, vx), _mm256_mul_ps(m12, vy)), _mm256_add_ps(_mm256_mul_ps(m22, vz), m32));
+
+		// No branches at all: min and max are single instructions.
+		minX = _mm256_min_ps(minX, tx);
+		minY = _mm256_min_ps(minY, ty);
+		minZ = _mm256_min_ps(minZ, tz);
+		maxX = _mm256_max_ps(maxX, tx);
+		maxY = _mm256_max_ps(maxY, ty);
+		maxZ = _mm256_max_ps(maxZ, tz);
 	}
-	else
+
+	// Now boil the 8 lanes down to one value each.
+	float lanes[6][8];
+	_mm256_storeu_ps(lanes[0], minX);
+	_mm256_storeu_ps(lanes[1], minY);
+	_mm256_storeu_ps(lanes[2], minZ);
+	_mm256_storeu_ps(lanes[3], maxX);
+	_mm256_storeu_ps(lanes[4], maxY);
+	_mm256_storeu_ps(lanes[5], maxZ);
+
+	for (int lane = 0; lane < 8; lane++)
 	{
-		// Create a new vertices array of size 1.
-		vertices = (VertexFormat*)malloc(sizeof(VertexFormat));
+		boxMin = glm::min(boxMin, glm::vec3(lanes[0][lane], lanes[1][lane], lanes[2][lane]));
+		boxMax = glm::max(boxMax, glm::vec3(lanes[3][lane], lanes[4][lane], lanes[5][lane]));
+	}
+#elif defined(PHYSICS_SSE)
+	__m128 m00 = _mm_set1_ps(m[0][0]), m01 = _mm_set1_ps(m[0][1]), m02 = _mm_set1_ps(m[0][2]);
+	__m128 m10 = _mm_set1_ps(m[1][0]), m11 = _mm_set1_ps(m[1][1]), m12 = _mm_set1_ps(m[1][2]);
+	__m128 m20 = _mm_set1_ps(m[2][0]), m21 = _mm_set1_ps(m[2][1]), m22 = _mm_set1_ps(m[2][2]);
+	__m128 m30 = _mm_set1_ps(m[3][0]), m31 = _mm_set1_ps(m[3][1]), m32 = _mm_set1_ps(m[3][2]);
 
-		// Set the value to the new vertex.
-		vertices[0] = *vert;
+	__m128 minX = _mm_set1_ps(boxMin.x), minY = _mm_set1_ps(boxMin.y), minZ = _mm_set1_ps(boxMin.z);
+	__m128 maxX = _mm_set1_ps(boxMax.x), maxY = _mm_set1_ps(boxMax.y), maxZ = _mm_set1_ps(boxMax.z);
 
-		// Set the number of vertices to 1.
-		numVertices = 1;
+	for (; i < end; i += 4)
+	{
+		__m128 vx = _mm_load_ps(x + i);
+		__m128 vy = _mm_load_ps(y + i);
+		__m128 vz = _mm_load_ps(z + i);
+
+		__m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m00, vx), _mm_mul_ps(m10, vy)), _mm_add_ps(_mm_mul_ps(m20, vz), m30));
+		__m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m01, vx), _mm_mul_ps(m11, vy)), _mm_add_ps(_mm_mul_ps(m21, vz), m31));
+		__m128 tz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m02, vx), _mm_mul_ps(m12, vy)), _mm_add_ps(_mm_mul_ps(m22, vz), m32));
+
+		// No branches at all: min and max are single instructions.
+		minX = _mm_min_ps(minX, tx);
+		minY = _mm_min_ps(minY, ty);
+		minZ = _mm_min_ps(minZ, tz);
+		maxX = _mm_max_ps(maxX, tx);
+		maxY = _mm_max_ps(maxY, ty);
+		maxZ = _mm_max_ps(maxZ, tz);
+	}
 
-		// Initialize the buffer.
-		InitBuffer();
+	// Now boil the 4 lanes down to one value each.
+	float lanes[6][4];
+	_mm_storeu_ps(lanes[0], minX);
+	_mm_storeu_ps(lanes[1], minY);
+	_mm_storeu_ps(lanes[2], minZ);
+	_mm_storeu_ps(lanes[3], maxX);
+	_mm_storeu_ps(lanes[4], maxY);
+	_mm_storeu_ps(lanes[5], maxZ);
 
-		// Return the index reference to this vertex (zero).
-		return 0;
+	for (int lane = 0; lane < 4; lane++)
+	{
+		boxMin = glm::min(boxMin, glm::vec3(lanes[0][lane], lanes[1][lane], lanes[2][lane]));
+		boxMax = glm::max(boxMax, glm::vec3(lanes[3][lane], lanes[4][lane], lanes[5][lane]));
+	}
+#else
+	for (; i < end; i++)
+	{
+		glm::vec3 t = glm::vec3(m * glm::vec4(x[i], y[i], z[i], 1.0f));
+		boxMin = glm::min(boxMin, t);
+		boxMax = glm::max(boxMax, t);
 	}
+#endif
 }
-void Model::AddIndex(GLuint index)
+
+AABB Model::TransformedAABB(const glm::mat4& transform) const
 {
-	if (numIndices > 0)
+	if (numVertices <= 0)
 	{
-		// Allocate space equivalent to our current indices array.
-		GLuint* tempInds = (GLuint*)malloc(sizeof(GLuint) * numIndices);
+		return AABB();
+	}
 
-		// Copy our current indices array into our temporary array.
-		memcpy(tempInds, indices, numIndices);
+	// Start the box out as the first vertex, like CalculateLocalAABB does.
+	glm::vec3 first = glm::vec3(transform * glm::vec4(vertices[0].position, 1.0f));
+	int padded = (numVertices + 7) & ~7;
 
-		// Increase the number of indices count by 1.
-		numIndices++;
+	// Splitting up a small mesh would cost more in handing out jobs than it saves.
+	const int verticesPerJob = 32768;
 
-		// Free the indices array.
-		free(indices);
+	if (jobs == nullptr || numVertices < verticesPerJob * 2)
+	{
+		AABB box(first, first);
+		TransformedBounds(transform, positionX, positionY, positionZ, 0, padded, box.min, box.max);
+		return box;
+	}
+
+	// Each chunk works out the box of its own vertices, and then those boxes are combined. Min and max give the same answer in any order, so the result is
+	// exactly the same as doing it all on one thread.
+	int numChunks = (padded + verticesPerJob - 1) / verticesPerJob;
+	std::vector<AABB> chunkBoxes(numChunks, AABB(first, first));
+	AABB* boxes = &chunkBoxes[0];
+	const float* x = positionX;
+	const float* y = positionY;
+	const float* z = positionZ;
+
+	jobs->ParallelFor(padded, verticesPerJob, [&transform, boxes, x, y, z, verticesPerJob](int begin, int end)
+	{
+		AABB& box = boxes[begin / verticesPerJob];
+		TransformedBounds(transform, x, y, z, begin, end, box.min, box.max);
+	});
 
-		// Allocate space equivalent to our new indices size.
-		indices = (GLuint*)malloc(sizeof(GLuint) * numIndices);
+	AABB box = chunkBoxes[0];
+	for (int i = 1; i < numChunks; i++)
+	{
+		box.min = glm::min(box.min, chunkBoxes[i].min);
+		box.max = glm::max(box.max, chunkBoxes[i].max);
+	}
 
-		// Copy the data from the temporary array back into the indices array.
-		memcpy(indices, tempInds, numIndices - 1);
+	return box;
+}
 
-		// Free the temporary array.
-		free(tempInds);
+unsigned int Model::AddVertex(VertexFormat* vert)
+{
+	return AddVertices(vert, 1);
+}
 
-		// Set the last value in the indices array to the new index.
-		indices[numIndices - 1] = index;
+unsigned int Model::AddVertices(const VertexFormat* verts, int count)
+{
+	unsigned int first = numVertices;
+
+	if (count <= 0)
+	{
+		return first;
 	}
-	else
+
+	// Make sure there's room for the new vertices, doubling the array if there isn't.
+	if (numVertices + count > vertexCapacity)
 	{
-		// Create a new indices array of size 1.
-		indices = (GLuint*)malloc(sizeof(GLuint));
+		Reserve(GrowCapacity(vertexCapacity, numVertices + count), indexCapacity);
+	}
 
-		// Set the value to the new index.
-		indices[0] = index;
+	// Copy the new vertices onto the end of the array.
+	memcpy(vertices + numVertices, verts, sizeof(VertexFormat) * count);
+	numVertices += count;
 
-		// Set the numIndices to 1.
-		numIndices = 1;
+	// Grow the local bounding box to fit the new vertices, and copy their positions into the position arrays.
+	GrowLocalAABB(first);
+	StreamPositions(first);
+
+	dirty = true;
+
+	// Return the index reference to the first new vertex.
+	return first;
+}
+
+void Model::AddIndex(unsigned int index)
+{
+	AddIndices(&index, 1);
+}
+
+void Model::AddIndices(const unsigned int* inds, int count)
+{
+	if (count <= 0)
+	{
+		return;
 	}
+
+	// Make sure there's room for the new indices, doubling the array if there isn't.
+	if (numIndices + count > indexCapacity)
+	{
+		Reserve(vertexCapacity, GrowCapacity(indexCapacity, numIndices + count));
+	}
+
+	// Copy the new indices onto the end of the array.
+	memcpy(indices + numIndices, inds, sizeof(unsigned int) * count);
+	numIndices += count;
+
+	dirty = true;
 }
 
 #endif _MODEL_CPP
\ No newline at end of file
@@ -40,7 +40,10 @@ simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
 #ifndef _MODEL_H
 #define _MODEL_H
 
-#include "GLIncludes.h"
+#include "MathIncludes.h"
+#include "AABB.h"
+#include "Simd.h"
+#include "JobSystem.h"
 
 class Model
 {
@@ -49,26 +52,86 @@ private:
 	VertexFormat* vertices;
 
 	int numIndices;
-	GLuint* indices;
+	unsigned int* indices;
 
-	GLuint vbo;
-	GLuint ebo;
+	// How many vertices and indices there is room for before the arrays have to grow. The arrays double in size whenever they run out of room, so adding
+	// one vertex at a time is just as fast (on average) as adding them all at once.
+	int vertexCapacity;
+	int indexCapacity;
 
-	//GLuint shaderProgram;
-	//GLuint m_Buffer;
+	unsigned int vbo;
+	unsigned int ebo;
+
+	// The vertex array object remembers which buffers this model's attributes come from (and its element buffer), so that binding it before drawing is all
+	// it takes to switch to this model. Without it, every draw would use whichever model set up the attributes last.
+	unsigned int vao;
+
+	// Holds one matrix per instance for DrawInstanced, and how many matrices it has room for.
+	unsigned int instanceVbo;
+	int instanceCapacity;
+
+	// True when the vertices or indices have changed since they were last sent to the GPU.
+	bool dirty;
+
+	// The bounding box of the vertices in model space (before any transformation). This is what lets GameObjects work out their world space AABB
+	// without looking at every vertex.
+	AABB localBox;
+
+	// A second copy of just the vertex positions, with all the x values in one array, all the y values in another, and all the z values in a third.
+	// In the vertices array, each position sits between the colors, so reading the positions alone still drags every color through the cache too (28 of
+	// every 44 bytes read are thrown away). These arrays have nothing else in them, and they are 32-byte aligned and padded to a multiple of 8 (with copies
+	// of the first position, which don't change the bounds), so TransformedAABB can work on 8 vertices at a time.
+	float* positionX;
+	float* positionY;
+	float* positionZ;
+	int positionCapacity;
+
+	// If set, TransformedAABB splits big meshes across the threads of this job system. The model doesn't own it.
+	JobSystem* jobs;
+
+	void CalculateLocalAABB();
+	void GrowLocalAABB(int first);
+
+	// Copies the positions of every vertex from first onwards into the position arrays.
+	void StreamPositions(int first);
+
+	//unsigned int shaderProgram;
+	//unsigned int m_Buffer;
 
 public:
-	Model(int numVerts = 0, VertexFormat* verts = nullptr, int numInds = 0, GLuint* inds = nullptr);
+	Model(int numVerts = 0, VertexFormat* verts = nullptr, int numInds = 0, unsigned int* inds = nullptr);
 	~Model();
 
-	GLuint AddVertex(VertexFormat*);
-	void AddIndex(GLuint);
+	// Adding vertices and indices only changes the copy in memory. Call Commit afterwards to send the changes to the GPU.
+	unsigned int AddVertex(VertexFormat*);
+	void AddIndex(unsigned int);
+
+	// Adds count vertices (or indices) at once. AddVertices returns the index of the first new vertex.
+	unsigned int AddVertices(const VertexFormat* verts, int count);
+	void AddIndices(const unsigned int* inds, int count);
+
+	// Makes room for at least this many vertices and indices in total, so that building a model of a known size only allocates once.
+	void Reserve(int vertexCount, int indexCount);
 
+	// These are the only functions that talk to OpenGL. They live in ModelGL.cpp, so that the physics code (which only needs the vertex data) can use
+	// models without linking OpenGL at all.
+	// InitBuffer creates the GPU buffers and uploads the data, UpdateBuffer re-uploads the data after it has changed, and ReleaseBuffer deletes the buffers.
+	// Commit uploads the data only if it has changed since the last upload (creating the buffers first if needed), so it's cheap to call every frame.
 	void InitBuffer();
 	void UpdateBuffer();
+	void ReleaseBuffer();
+	void Commit();
 
 	void Draw();
 
+	// Draws the model count times in a single draw call, once with each of the given matrices. The matrices are sent to the shader as a per-instance
+	// attribute in locations 2 to 5 (a mat4 takes up four attribute locations), so this needs a shader like InstancedVertexShader.glsl.
+	void DrawInstanced(const glm::mat4* matrices, int count);
+
+	// Draws the model count times in a single draw call, with no per-instance attributes at all. The shader has to find each instance's data itself from
+	// gl_InstanceID (like StorageVertexShader.glsl does).
+	void DrawInstances(int count);
+
 	// Our get variables.
 	int NumVertices()
 	{
@@ -82,10 +145,27 @@ public:
 	{
 		return vertices;
 	}
-	GLuint* Indices()
+	unsigned int* Indices()
 	{
 		return indices;
 	}
+	AABB LocalAABB()
+	{
+		return localBox;
+	}
+
+	// Transforms every vertex by the given matrix, and returns the box that fits around all of them. This is the exact (tight) world space box of the model.
+	// It runs over the position arrays with SSE or AVX, and is split across threads for big meshes if the model has a job system.
+	AABB TransformedAABB(const glm::mat4& transform) const;
+
+	void SetJobSystem(JobSystem* j)
+	{
+		jobs = j;
+	}
+	bool IsDirty()
+	{
+		return dirty;
+	}
 
 	/*Model(int p_nVertices = 3, float _size = 1.0f, float _originX = 0.0f, float _originY = 0.0f, float _originZ = 0.0f)
 	{
@@ -191,7 +271,7 @@ public:
 //		glBindBuffer(GL_ARRAY_BUFFER, m_Buffer);
 //
 //		// Initialize the vertex position attribute from the vertex shader.
-//		GLuint loc = glGetAttribLocation(m_ShaderProgram, "vPosition");
+//		unsigned int loc = glGetAttribLocation(m_ShaderProgram, "vPosition");
 //		glEnableVertexAttribArray(loc);
 //		glVertexAttribPointer(loc, 3, GL_FLOAT, GL_FALSE, 0, BUFFER_OFFSET(0));
 //
@@ -203,7 +283,7 @@ public:
 //	void InitBuffer(void)
 //	{
 //		// Create a vertex array object
-//		GLuint vao;
+//		unsigned int vao;
 //		glGenVertexArrays(1, &vao);
 //		glBindVertexArray(vao);
 //
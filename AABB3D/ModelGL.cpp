@@ -0,0 +1,241 @@
+/*
+Title: AABB-3D
+File Name: ModelGL.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _MODEL_GL_CPP
+#define _MODEL_GL_CPP
+
+// This file holds every part of Model that needs OpenGL. It is only built into the windowed program, not the physics library.
+#include "GLIncludes.h"
+#include "Model.h"
+
+void Model::InitBuffer()
+{
+	// This generates buffer object names
+	// The first parameter is the number of buffer objects, and the second parameter is a pointer to an array of buffer objects (yes, before this call, vbo was an empty variable)
+	// (In this example, there's only one buffer object.)
+	glGenBuffers(1, &vbo);
+	glGenBuffers(1, &ebo);
+
+	// Everything from here until the vertex array is unbound (the element buffer binding and the attribute setup) is saved in this model's vertex array.
+	glGenVertexArrays(1, &vao);
+	glBindVertexArray(vao);
+
+	//// Binds a named buffer object to the specified buffer binding point. Give it a target (GL_ARRAY_BUFFER) to determine where to bind the buffer.
+	//// There are several different target parameters, GL_ARRAY_BUFFER is for vertex attributes, feel free to Google the others to find out what else there is.
+	//// The second paramter is the buffer object reference. If no buffer object with the given name exists, it will create one.
+	//// Buffer object names are unsigned integers (like vbo). Zero is a reserved value, and there is no default buffer for each target (targets, like GL_ARRAY_BUFFER).
+	//// Passing in zero as the buffer name (second parameter) will result in unbinding any buffer bound to that target, and frees up the memory.
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+
+	//// GL_ELEMENT_ARRAY_BUFFER is for vertex array indices, all drawing commands of glDrawElements will use indices from that buffer.
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+	//// Creates and initializes a buffer object's data.
+	//// First parameter is the target, second parameter is the size of the buffer, third parameter is a pointer to the data that will copied into the buffer, and fourth parameter is the 
+	//// expected usage pattern of the data. Possible usage patterns: GL_STREAM_DRAW, GL_STREAM_READ, GL_STREAM_COPY, GL_STATIC_DRAW, GL_STATIC_READ, GL_STATIC_COPY, GL_DYNAMIC_DRAW, 
+	//// GL_DYNAMIC_READ, or GL_DYNAMIC_COPY
+	//// Stream means that the data will be modified once, and used only a few times at most. Static means that the data will be modified once, and used a lot. Dynamic means that the data 
+	//// will be modified repeatedly, and used a lot. Draw means that the data is modified by the application, and used as a source for GL drawing. Read means the data is modified by 
+	//// reading data from GL, and used to return that data when queried by the application. Copy means that the data is modified by reading from the GL, and used as a source for drawing.
+	glBufferData(GL_ARRAY_BUFFER, sizeof(VertexFormat) * numVertices, vertices, GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * numIndices, indices, GL_STATIC_DRAW);
+
+	//// By default, all client-side capabilities are disabled, including all generic vertex attribute arrays.
+	//// When enabled, the values in a generic vertex attribute array will be accessed and used for rendering when calls are made to vertex array commands (like glDrawArrays/glDrawElements)
+	//// A GL_INVALID_VALUE will be generated if the index parameter is greater than or equal to GL_MAX_VERTEX_ATTRIBS
+	glEnableVertexAttribArray(0);
+
+	//// Defines an array of generic vertex attribute data. Takes an index, a size specifying the number of components (in this case, floats)(has a max of 4)
+	//// The third parameter, type, can be GL_BYTE, GL_UNSIGNED_BYTE, GL_SHORT, GL_UNSIGNED_SHORT, GL_FIXED, or GL_FLOAT
+	//// The fourth parameter specifies whether to normalize fixed-point data values, the fifth parameter is the stride which is the offset (in bytes) between generic vertex attributes
+	//// The fifth parameter is a pointer to the first component of the first generic vertex attribute in the array. If a named buffer object is bound to GL_ARRAY_BUFFER (and it is, in this case) 
+	//// then the pointer parameter is treated as a byte offset into the buffer object's data.
+	glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)16);
+	//// You'll note sizeof(VertexFormat) is our stride, because each vertex contains data that adds up to that size.
+	//// You'll also notice we offset this parameter by 16 bytes, this is because the vec3 position attribute is after the vec4 color attribute. A vec4 has 4 floats, each being 4 bytes 
+	//// so we offset by 4*4=16 to make sure that our first attribute is actually the position. The reason we put position after color in the struct has to do with padding.
+	//// For more info on padding, Google it.
+
+	//// This is our color attribute, so the offset is 0, and the size is 4 since there are 4 floats for color.
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(VertexFormat), (void*)0);
+
+	// Unbind the vertex array, so that nothing else that binds an element buffer changes this one by accident.
+	glBindVertexArray(0);
+
+	// Everything is on the GPU now.
+	dirty = false;
+}
+
+void Model::UpdateBuffer()
+{
+	// Make sure we're writing into this model's buffers, and not whichever ones happened to be bound last. The element buffer binding belongs to whichever
+	// vertex array is bound, so bind ours first.
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, ebo);
+
+	//// Creates and initializes a buffer object's data.
+	//// First parameter is the target, second parameter is the size of the buffer, third parameter is a pointer to the data that will copied into the buffer, and fourth parameter is the 
+	//// expected usage pattern of the data. Possible usage patterns: GL_STREAM_DRAW, GL_STREAM_READ, GL_STREAM_COPY, GL_STATIC_DRAW, GL_STATIC_READ, GL_STATIC_COPY, GL_DYNAMIC_DRAW, 
+	//// GL_DYNAMIC_READ, or GL_DYNAMIC_COPY
+	//// Stream means that the data will be modified once, and used only a few times at most. Static means that the data will be modified once, and used a lot. Dynamic means that the data 
+	//// will be modified repeatedly, and used a lot. Draw means that the data is modified by the application, and used as a source for GL drawing. Read means the data is modified by 
+	//// reading data from GL, and used to return that data when queried by the application. Copy means that the data is modified by reading from the GL, and used as a source for drawing.
+	glBufferData(GL_ARRAY_BUFFER, sizeof(VertexFormat) * numVertices, vertices, GL_STATIC_DRAW);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLuint) * numIndices, indices, GL_STATIC_DRAW);
+
+	glBindVertexArray(0);
+
+	dirty = false;
+}
+
+void Model::Commit()
+{
+	if (vbo == 0)
+	{
+		// The buffers haven't been created yet, so create them (which uploads everything).
+		InitBuffer();
+	}
+	else if (dirty)
+	{
+		UpdateBuffer();
+	}
+}
+
+void Model::Draw()
+{
+	// Draw vertices from the buffer as GL_TRIANGLES
+	// There are several different drawing modes, GL_TRIANGLES takes every 3 vertices and makes them a triangle.
+	// For reference, GL_TRIANGLE_STRIP would take each additional vertex after the first 3 and consider that a 
+	// triangle with the previous 2 vertices (so you could make 2 triangles with 4 vertices)
+	// The second parameter is the offset, the third parameter is the number of vertices to draw.
+	//glDrawArrays(GL_TRIANGLES, 0, numVertices);
+
+
+
+	// Draw numIndices vertices from the buffer as GL_TRIANGLES
+	// There are several different drawing modes, GL_TRIANGLES takes every 3 vertices and makes them a triangle.
+	// For reference, GL_TRIANGLE_STRIP would take each additional vertex after the first 3 and consider that a 
+	// triangle with the previous 2 vertices (so you could make 2 triangles with 4 vertices)
+	// The second parameter is the number of vertices, the third parameter is the type of the element buffer data, and the fourth parameter is the offset.
+	glBindVertexArray(vao);
+	glDrawElements(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0);
+}
+
+void Model::DrawInstanced(const glm::mat4* matrices, int count)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	if (instanceVbo == 0)
+	{
+		glGenBuffers(1, &instanceVbo);
+	}
+
+	// The per-instance attributes set up below get saved in this model's vertex array, along with its vertex attributes.
+	glBindVertexArray(vao);
+	glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+
+	// Grow the buffer (doubling, like the vertex array) so that it doesn't have to be resized every time an object is added.
+	if (count > instanceCapacity)
+	{
+		instanceCapacity = instanceCapacity < 64 ? 64 : instanceCapacity;
+		while (instanceCapacity < count)
+		{
+			instanceCapacity *= 2;
+		}
+	}
+
+	// Passing nullptr "orphans" the old data, so the driver can hand us fresh memory instead of waiting for the GPU to finish drawing last frame's matrices.
+	glBufferData(GL_ARRAY_BUFFER, sizeof(glm::mat4) * instanceCapacity, nullptr, GL_STREAM_DRAW);
+
+	// The matrices change every frame, so we upload them every frame.
+	glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(glm::mat4) * count, matrices);
+
+	// A mat4 attribute is really four vec4 attributes in a row, one per column (glm matrices are column major, the same as GLSL).
+	// glVertexAttribDivisor(location, 1) makes the attribute advance once per instance instead of once per vertex.
+	for (int i = 0; i < 4; i++)
+	{
+		glEnableVertexAttribArray(2 + i);
+		glVertexAttribPointer(2 + i, 4, GL_FLOAT, GL_FALSE, sizeof(glm::mat4), (void*)(sizeof(glm::vec4) * i));
+		glVertexAttribDivisor(2 + i, 1);
+	}
+
+	// The same as glDrawElements, except the whole thing is repeated count times.
+	glDrawElementsInstanced(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0, count);
+}
+
+void Model::DrawInstances(int count)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	glBindVertexArray(vao);
+
+	// DrawInstanced may have left the per-instance matrix attributes turned on in this model's vertex array. The shader doesn't read them, but OpenGL would
+	// still fetch them (past the end of instanceVbo, if there are more instances than it has room for), so turn them off.
+	for (int i = 0; i < 4; i++)
+	{
+		glDisableVertexAttribArray(2 + i);
+	}
+
+	glDrawElementsInstanced(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, 0, count);
+}
+
+void Model::ReleaseBuffer()
+{
+	// Deleting buffer 0 is silently ignored, so this is safe even if InitBuffer was never called.
+	glDeleteBuffers(1, &vbo);
+	glDeleteBuffers(1, &ebo);
+	glDeleteBuffers(1, &instanceVbo);
+	glDeleteVertexArrays(1, &vao);
+
+	vbo = 0;
+	ebo = 0;
+	instanceVbo = 0;
+	instanceCapacity = 0;
+	vao = 0;
+}
+
+#endif // _MODEL_GL_CPP
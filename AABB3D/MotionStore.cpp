@@ -0,0 +1,202 @@
+/*
+Title: AABB-3D
+File Name: MotionStore.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _MOTION_STORE_CPP
+#define _MOTION_STORE_CPP
+
+#include "MotionStore.h"
+#include <cstring>
+
+MotionStore::MotionStore()
+{
+	positionX = positionY = positionZ = nullptr;
+	velocityX = velocityY = velocityZ = nullptr;
+	accelerationX = accelerationY = accelerationZ = nullptr;
+	awake = nullptr;
+	size = 0;
+	capacity = 0;
+	version = 0;
+}
+
+MotionStore::~MotionStore()
+{
+	float* arrays[10] = { positionX, positionY, positionZ, velocityX, velocityY, velocityZ, accelerationX, accelerationY, accelerationZ, awake };
+
+	for (int i = 0; i < 10; i++)
+	{
+		AlignedFree(arrays[i]);
+	}
+}
+
+void MotionStore::Grow(int newCapacity)
+{
+	// Always keep the capacity a multiple of 8, so the vector loop can work on whole blocks without running off the end.
+	newCapacity = (newCapacity + 7) & ~7;
+
+	float** arrays[10] = { &positionX, &positionY, &positionZ, &velocityX, &velocityY, &velocityZ, &accelerationX, &accelerationY, &accelerationZ, &awake };
+
+	for (int i = 0; i < 10; i++)
+	{
+		float* newArray = AlignedAlloc(newCapacity);
+
+		if (*arrays[i] != nullptr)
+		{
+			memcpy(newArray, *arrays[i], sizeof(float) * size);
+			AlignedFree(*arrays[i]);
+		}
+
+		// Zero out the padding past the end.
+		memset(newArray + size, 0, sizeof(float) * (newCapacity - size));
+
+		*arrays[i] = newArray;
+	}
+
+	capacity = newCapacity;
+}
+
+void MotionStore::Reserve(int count)
+{
+	if (count > capacity)
+	{
+		Grow(count);
+	}
+}
+
+int MotionStore::Add(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& acceleration)
+{
+	if (size == capacity)
+	{
+		// Double the capacity (starting at 16), so adding objects one at a time doesn't copy the arrays every time.
+		Grow(capacity < 16 ? 16 : capacity * 2);
+	}
+
+	int index = size;
+	size++;
+
+	SetPosition(index, position);
+	SetVelocity(index, velocity);
+	SetAcceleration(index, acceleration);
+	SetAwake(index, true);
+
+	return index;
+}
+
+void MotionStore::Remove(int index)
+{
+	float* arrays[10] = { positionX, positionY, positionZ, velocityX, velocityY, velocityZ, accelerationX, accelerationY, accelerationZ, awake };
+
+	int last = size - 1;
+
+	for (int i = 0; i < 10; i++)
+	{
+		// Move the last object into the removed one's slot, then zero out the slot that just became padding.
+		arrays[i][index] = arrays[i][last];
+		arrays[i][last] = 0.0f;
+	}
+
+	size--;
+}
+
+void MotionStore::Clear()
+{
+	float* arrays[10] = { positionX, positionY, positionZ, velocityX, velocityY, velocityZ, accelerationX, accelerationY, accelerationZ, awake };
+
+	for (int i = 0; i < 10 && size > 0; i++)
+	{
+		memset(arrays[i], 0, sizeof(float) * size);
+	}
+
+	size = 0;
+}
+
+void MotionStore::Integrate(float dt)
+{
+	IntegrateRange(dt, 0, size);
+	MarkMoved();
+}
+
+void MotionStore::IntegrateRange(float dt, int begin, int end)
+{
+	float* position[3] = { positionX, positionY, positionZ };
+	float* velocity[3] = { velocityX, velocityY, velocityZ };
+	float* acceleration[3] = { accelerationX, accelerationY, accelerationZ };
+	const float* w = awake;
+
+	// The padding is all zeros, so we can round the end up to a whole block and skip worrying about a leftover partial block. (If the end isn't the end of
+	// the store, the caller is splitting it on whole blocks anyway.)
+	end = (end + 7) & ~7;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float* p = position[axis];
+		float* v = velocity[axis];
+		const float* a = acceleration[axis];
+
+#if defined(PHYSICS_AVX)
+		__m256 step = _mm256_set1_ps(dt);
+
+		for (int i = begin; i < end; i += 8)
+		{
+			__m256 awakeStep = _mm256_mul_ps(_mm256_load_ps(w + i), step);
+			__m256 newVelocity = _mm256_add_ps(_mm256_load_ps(v + i), _mm256_mul_ps(_mm256_load_ps(a + i), awakeStep));
+			_mm256_store_ps(v + i, newVelocity);
+			_mm256_store_ps(p + i, _mm256_add_ps(_mm256_load_ps(p + i), _mm256_mul_ps(newVelocity, awakeStep)));
+		}
+#elif defined(PHYSICS_SSE)
+		__m128 step = _mm_set1_ps(dt);
+
+		for (int i = begin; i < end; i += 4)
+		{
+			__m128 awakeStep = _mm_mul_ps(_mm_load_ps(w + i), step);
+			__m128 newVelocity = _mm_add_ps(_mm_load_ps(v + i), _mm_mul_ps(_mm_load_ps(a + i), awakeStep));
+			_mm_store_ps(v + i, newVelocity);
+			_mm_store_ps(p + i, _mm_add_ps(_mm_load_ps(p + i), _mm_mul_ps(newVelocity, awakeStep)));
+		}
+#else
+		for (int i = begin; i < end; i++)
+		{
+			float awakeStep = w[i] * dt;
+			v[i] += a[i] * awakeStep;
+			p[i] += v[i] * awakeStep;
+		}
+#endif
+	}
+}
+
+#endif // _MOTION_STORE_CPP
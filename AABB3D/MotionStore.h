@@ -0,0 +1,152 @@
+/*
+Title: AABB-3D
+File Name: MotionStore.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _MOTION_STORE_H
+#define _MOTION_STORE_H
+
+#include "MathIncludes.h"
+#include "Simd.h"
+
+// Stores the position, velocity, and acceleration of a set of objects as a structure of arrays (one array of every position x, one of every position y, and
+// so on), so that they can all be moved forward in one tight loop.
+// Moving one GameObject at a time means following a pointer to each object, pulling in a whole cache line of matrices we don't need, and making a function
+// call, all just to do six multiply-adds. Laid out like this, the integration loop reads and writes nothing but the nine arrays from start to finish, 4 or 8
+// objects per instruction, so it only goes as fast as memory can feed it.
+// The arrays are 32-byte aligned and padded to a multiple of 8 objects. Padding objects are all zeros (and asleep), so integrating them does nothing.
+class MotionStore
+{
+	float* positionX;
+	float* positionY;
+	float* positionZ;
+	float* velocityX;
+	float* velocityY;
+	float* velocityZ;
+	float* accelerationX;
+	float* accelerationY;
+	float* accelerationZ;
+
+	// 1 for an object that is awake, and 0 for one that is asleep. The integration multiplies dt by this, so sleeping objects stay put without the loop
+	// needing a branch (and multiplying by exactly 1 doesn't change the result for awake objects at all).
+	float* awake;
+
+	int size;
+	int capacity;
+
+	// Goes up by one every time Integrate runs, so that objects can tell that their position has changed since they last looked.
+	unsigned int version;
+
+	void Grow(int newCapacity);
+
+	// Copying would mean two stores freeing the same arrays.
+	MotionStore(const MotionStore&);
+	MotionStore& operator=(const MotionStore&);
+
+public:
+	MotionStore();
+	~MotionStore();
+
+	// Adds an object to the end of the store and returns its index.
+	int Add(const glm::vec3& position, const glm::vec3& velocity, const glm::vec3& acceleration);
+
+	// Removes the object at the given index by moving the last object into its place, so removing is O(1) no matter how many objects there are.
+	// The order isn't kept, so whoever owns the last object has to update its index.
+	void Remove(int index);
+
+	void Clear();
+	void Reserve(int count);
+
+	int Size() const
+	{
+		return size;
+	}
+	unsigned int GetVersion() const
+	{
+		return version;
+	}
+
+	glm::vec3 GetPosition(int index) const
+	{
+		return glm::vec3(positionX[index], positionY[index], positionZ[index]);
+	}
+	glm::vec3 GetVelocity(int index) const
+	{
+		return glm::vec3(velocityX[index], velocityY[index], velocityZ[index]);
+	}
+	glm::vec3 GetAcceleration(int index) const
+	{
+		return glm::vec3(accelerationX[index], accelerationY[index], accelerationZ[index]);
+	}
+
+	void SetPosition(int index, const glm::vec3& position)
+	{
+		positionX[index] = position.x;
+		positionY[index] = position.y;
+		positionZ[index] = position.z;
+	}
+	void SetVelocity(int index, const glm::vec3& velocity)
+	{
+		velocityX[index] = velocity.x;
+		velocityY[index] = velocity.y;
+		velocityZ[index] = velocity.z;
+	}
+	void SetAcceleration(int index, const glm::vec3& acceleration)
+	{
+		accelerationX[index] = acceleration.x;
+		accelerationY[index] = acceleration.y;
+		accelerationZ[index] = acceleration.z;
+	}
+	void SetAwake(int index, bool isAwake)
+	{
+		awake[index] = isAwake ? 1.0f : 0.0f;
+	}
+
+	// Moves every awake object forward by dt, the same way GameObject::Update does: velocity += acceleration * dt, then position += velocity * dt.
+	void Integrate(float dt);
+
+	// Moves only the objects from begin up to end forward by dt, so that different threads can each take a part of the store. begin must be a multiple of 8.
+	// This doesn't change the version, so call MarkMoved once every part is done.
+	void IntegrateRange(float dt, int begin, int end);
+
+	void MarkMoved()
+	{
+		version++;
+	}
+};
+
+#endif //_MOTION_STORE_H
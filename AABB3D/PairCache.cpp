@@ -0,0 +1,180 @@
+/*
+Title: AABB-3D
+File Name: PairCache.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PAIR_CACHE_CPP
+#define _PAIR_CACHE_CPP
+
+#include "PairCache.h"
+#include <algorithm>
+
+PairCache::PairCache()
+{
+	step = 0;
+}
+
+// Removes the pair at the given position by moving the last pair into its place, which is O(1) instead of shifting everything after it down.
+void PairCache::RemoveAt(int position)
+{
+	index.erase(Key(pairs[position].pair.proxyA, pairs[position].pair.proxyB));
+
+	int last = (int)pairs.size() - 1;
+	if (position != last)
+	{
+		pairs[position] = pairs[last];
+		index[Key(pairs[position].pair.proxyA, pairs[position].pair.proxyB)] = position;
+	}
+
+	pairs.pop_back();
+}
+
+void PairCache::Update(const std::vector<BroadphasePair>& overlapping, std::vector<PairEvent>& events)
+{
+	PurgeRemovedProxies();
+
+	events.clear();
+	step++;
+
+	for (size_t i = 0; i < overlapping.size(); i++)
+	{
+		const BroadphasePair& pair = overlapping[i];
+		unsigned long long key = Key(pair.proxyA, pair.proxyB);
+
+		PairEvent event;
+		event.pair = pair;
+
+		std::unordered_map<unsigned long long, int>::iterator found = index.find(key);
+
+		if (found == index.end())
+		{
+			// We haven't seen this pair before, so it just started overlapping.
+			CachedPair cached;
+			cached.pair = pair;
+			cached.lastSeen = step;
+
+			index[key] = (int)pairs.size();
+			pairs.push_back(cached);
+
+			event.type = PairEvent::BEGIN;
+		}
+		else
+		{
+			pairs[found->second].lastSeen = step;
+			event.type = PairEvent::STAY;
+		}
+
+		events.push_back(event);
+	}
+
+	// Any pair that wasn't seen this step has stopped overlapping.
+	// We walk backwards so that the pair swapped in by RemoveAt has already been looked at.
+	for (int i = (int)pairs.size() - 1; i >= 0; i--)
+	{
+		if (pairs[i].lastSeen != step)
+		{
+			PairEvent event;
+			event.type = PairEvent::END;
+			event.pair = pairs[i].pair;
+			events.push_back(event);
+
+			RemoveAt(i);
+		}
+	}
+}
+
+void PairCache::RemoveProxy(int proxy)
+{
+	removedProxies.push_back(proxy);
+}
+
+void PairCache::PurgeRemovedProxies()
+{
+	if (removedProxies.empty())
+	{
+		return;
+	}
+
+	// Sorting the removed proxies lets us check each pair against all of them with a binary search.
+	std::sort(removedProxies.begin(), removedProxies.end());
+
+	for (int i = (int)pairs.size() - 1; i >= 0; i--)
+	{
+		if (std::binary_search(removedProxies.begin(), removedProxies.end(), pairs[i].pair.proxyA) ||
+			std::binary_search(removedProxies.begin(), removedProxies.end(), pairs[i].pair.proxyB))
+		{
+			RemoveAt(i);
+		}
+	}
+
+	removedProxies.clear();
+}
+
+void PairCache::RefreshProxies()
+{
+	// The pairs of removed objects have to go first, since their objects may not exist anymore.
+	PurgeRemovedProxies();
+	index.clear();
+
+	for (size_t i = 0; i < pairs.size(); i++)
+	{
+		BroadphasePair& pair = pairs[i].pair;
+
+		// Keep proxyA the smaller of the two, swapping the objects along with them.
+		int a = pair.objectA->GetProxy();
+		int b = pair.objectB->GetProxy();
+
+		if (a > b)
+		{
+			std::swap(a, b);
+			std::swap(pair.objectA, pair.objectB);
+		}
+
+		pair.proxyA = a;
+		pair.proxyB = b;
+		index[Key(a, b)] = (int)i;
+	}
+}
+
+void PairCache::Clear()
+{
+	pairs.clear();
+	index.clear();
+	removedProxies.clear();
+}
+
+#endif // _PAIR_CACHE_CPP
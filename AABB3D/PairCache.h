@@ -0,0 +1,120 @@
+/*
+Title: AABB-3D
+File Name: PairCache.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PAIR_CACHE_H
+#define _PAIR_CACHE_H
+
+#include "Broadphase.h"
+#include <vector>
+#include <unordered_map>
+
+// Something that happened to a pair of objects this step.
+struct PairEvent
+{
+	enum Type
+	{
+		BEGIN,	// The pair started overlapping this step.
+		STAY,	// The pair was overlapping last step, and still is.
+		END		// The pair was overlapping last step, and isn't anymore.
+	};
+
+	Type type;
+	BroadphasePair pair;
+};
+
+// Remembers which pairs of objects were overlapping last step, so that we can tell when a pair starts overlapping, keeps overlapping, and stops overlapping.
+// Collision response usually only cares about the moment two objects first touch. Without knowing which pairs were touching last step, a pair that takes
+// a few steps to separate would get "bounced" again every step it was still overlapping, and the two objects would get stuck flipping back and forth.
+// Pairs are looked up in a hash table by their two proxy IDs, so each step costs O(overlapping pairs), not O(objects).
+class PairCache
+{
+	struct CachedPair
+	{
+		BroadphasePair pair;
+
+		// The last step this pair was seen overlapping in.
+		unsigned int lastSeen;
+	};
+
+	std::vector<CachedPair> pairs;
+
+	// Maps the key of a pair to where it is in the pairs list.
+	std::unordered_map<unsigned long long, int> index;
+
+	unsigned int step;
+
+	// The proxies passed to RemoveProxy since the last Update, whose pairs haven't been forgotten yet.
+	std::vector<int> removedProxies;
+
+	static unsigned long long Key(int proxyA, int proxyB)
+	{
+		return ((unsigned long long)(unsigned int)proxyA << 32) | (unsigned int)proxyB;
+	}
+
+	void RemoveAt(int position);
+
+	// Forgets every pair involving one of the removed proxies, in a single pass over the pairs.
+	void PurgeRemovedProxies();
+
+public:
+	PairCache();
+
+	// Takes every pair that is overlapping this step, and fills events with what changed since the last call. BEGIN and STAY events come out in the same
+	// order as the overlapping pairs, followed by the END events.
+	void Update(const std::vector<BroadphasePair>& overlapping, std::vector<PairEvent>& events);
+
+	// Forgets every pair involving the given proxy, without any END events. Call this when an object is removed, since its proxy ID can be handed out to a
+	// new object later.
+	// So that removing lots of objects doesn't mean a pass over every pair for each one, the pairs are actually forgotten at the start of the next Update
+	// (or RefreshProxies). Nothing new is added to the cache before then, so any pair with this proxy in it until then belongs to the removed object.
+	void RemoveProxy(int proxy);
+
+	// Re-reads every pair's proxy IDs from its objects. Call this after the objects have been moved to a new broadphase (which gives them new proxy IDs).
+	void RefreshProxies();
+
+	void Clear();
+
+	// The number of pairs that were overlapping as of the last Update.
+	int Size()
+	{
+		return (int)pairs.size();
+	}
+};
+
+#endif //_PAIR_CACHE_H
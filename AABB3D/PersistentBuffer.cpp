@@ -0,0 +1,180 @@
+/*
+Title: AABB-3D
+File Name: PersistentBuffer.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PERSISTENT_BUFFER_CPP
+#define _PERSISTENT_BUFFER_CPP
+
+// This file needs OpenGL, so it is only built into the windowed program, not the physics library.
+#include "PersistentBuffer.h"
+
+PersistentBuffer::PersistentBuffer(GLenum bufferTarget)
+{
+	target = bufferTarget;
+	buffer = 0;
+	mapped = nullptr;
+	regionSize = 0;
+	capacity = 0;
+	region = 0;
+
+	for (int i = 0; i < NUM_REGIONS; i++)
+	{
+		fences[i] = 0;
+	}
+}
+
+PersistentBuffer::~PersistentBuffer()
+{
+	// The buffer has to be released with Release while the OpenGL context is still around, so there's nothing to do here.
+}
+
+bool PersistentBuffer::Supported()
+{
+	return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+void PersistentBuffer::Create(GLsizeiptr size)
+{
+	// A buffer range has to start on a multiple of the offset alignment for its target (often 256 bytes), so each region is rounded up to one.
+	GLint alignment = 256;
+	glGetIntegerv(target == GL_UNIFORM_BUFFER ? GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT : GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+	if (alignment < 1)
+	{
+		alignment = 1;
+	}
+
+	capacity = size;
+	regionSize = (size + alignment - 1) / alignment * alignment;
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(target, buffer);
+
+	// glBufferStorage is like glBufferData, except the buffer can never be resized afterwards, which is what lets the driver keep it mapped.
+	// GL_MAP_PERSISTENT_BIT lets us keep it mapped while the GPU draws with it, and GL_MAP_COHERENT_BIT makes anything we write show up on the GPU without
+	// having to flush it ourselves.
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+	glBufferStorage(target, regionSize * NUM_REGIONS, nullptr, flags);
+	mapped = (char*)glMapBufferRange(target, 0, regionSize * NUM_REGIONS, flags);
+
+	region = 0;
+}
+
+void PersistentBuffer::WaitForRegion(int index)
+{
+	if (fences[index] == 0)
+	{
+		return;
+	}
+
+	// The first wait flushes any commands that haven't been sent to the GPU yet, so that the fence can actually be reached. After that we just keep waiting
+	// (a millisecond at a time) until the GPU gets there. Usually it already has, since this region was last used two frames ago.
+	GLbitfield waitFlags = GL_SYNC_FLUSH_COMMANDS_BIT;
+
+	while (true)
+	{
+		GLenum result = glClientWaitSync(fences[index], waitFlags, 1000000);
+
+		if (result == GL_ALREADY_SIGNALED || result == GL_CONDITION_SATISFIED || result == GL_WAIT_FAILED)
+		{
+			break;
+		}
+
+		waitFlags = 0;
+	}
+
+	glDeleteSync(fences[index]);
+	fences[index] = 0;
+}
+
+void* PersistentBuffer::Begin(GLsizeiptr size)
+{
+	if (size > capacity)
+	{
+		// The buffer can't be resized, so make a new one. Grow it by doubling so this only happens a few times as the scene grows.
+		GLsizeiptr newSize = capacity < 256 ? 256 : capacity;
+		while (newSize < size)
+		{
+			newSize *= 2;
+		}
+
+		Release();
+		Create(newSize);
+	}
+	else
+	{
+		region = (region + 1) % NUM_REGIONS;
+	}
+
+	WaitForRegion(region);
+
+	return mapped + regionSize * region;
+}
+
+void PersistentBuffer::Bind(GLuint index, GLsizeiptr offset, GLsizeiptr size)
+{
+	glBindBufferRange(target, index, buffer, regionSize * region + offset, size);
+}
+
+void PersistentBuffer::End()
+{
+	fences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+void PersistentBuffer::Release()
+{
+	// Wait for the GPU to be done with every region before the memory goes away.
+	for (int i = 0; i < NUM_REGIONS; i++)
+	{
+		WaitForRegion(i);
+	}
+
+	if (buffer != 0)
+	{
+		glBindBuffer(target, buffer);
+		glUnmapBuffer(target);
+		glDeleteBuffers(1, &buffer);
+	}
+
+	buffer = 0;
+	mapped = nullptr;
+	regionSize = 0;
+	capacity = 0;
+}
+
+#endif // _PERSISTENT_BUFFER_CPP
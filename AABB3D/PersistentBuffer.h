@@ -0,0 +1,97 @@
+/*
+Title: AABB-3D
+File Name: PersistentBuffer.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PERSISTENT_BUFFER_H
+#define _PERSISTENT_BUFFER_H
+
+#include "GLIncludes.h"
+
+// A buffer on the GPU that stays mapped into our memory for its whole life, so that data can be written straight into it every frame without calling
+// glBufferData or glBufferSubData (and without the driver making its own copy of the data first).
+// The catch is that the GPU may still be drawing with last frame's data while we write the next frame's. To keep from writing over data that's still in use,
+// the buffer is split into three regions, and we move on to the next one every frame. Each region gets a fence once the frame that used it has been
+// submitted, and before we write into a region again we wait on its fence. With three regions, the CPU can get two frames ahead of the GPU before it ever
+// has to wait.
+// This needs OpenGL 4.4 (or ARB_buffer_storage). See Supported.
+class PersistentBuffer
+{
+	static const int NUM_REGIONS = 3;
+
+	// What the buffer gets bound to (GL_UNIFORM_BUFFER or GL_SHADER_STORAGE_BUFFER).
+	GLenum target;
+
+	GLuint buffer;
+
+	// The whole buffer, mapped into our memory.
+	char* mapped;
+
+	// The size of each region in bytes (rounded up so that every region starts where the target allows a buffer range to start), and how many bytes of
+	// that the caller asked for.
+	GLsizeiptr regionSize;
+	GLsizeiptr capacity;
+
+	// The region being written this frame, and the fence for each region (0 if nothing is using it).
+	int region;
+	GLsync fences[NUM_REGIONS];
+
+	void Create(GLsizeiptr size);
+	void WaitForRegion(int index);
+
+public:
+	PersistentBuffer(GLenum bufferTarget);
+	~PersistentBuffer();
+
+	// True if the current OpenGL context can make persistently mapped buffers.
+	static bool Supported();
+
+	// Moves on to the next region and waits until the GPU is done with it, then returns where to write this frame's data. The region has room for at least
+	// size bytes (the buffer is recreated bigger if it didn't).
+	void* Begin(GLsizeiptr size);
+
+	// Binds size bytes of this frame's region, starting offset bytes in, to the given binding point in the shaders.
+	void Bind(GLuint index, GLsizeiptr offset, GLsizeiptr size);
+
+	// Call once every draw call that reads this frame's region has been made. This puts down the fence that the region waits on before it gets written again.
+	void End();
+
+	// Deletes the buffer. It gets created again by the next Begin.
+	void Release();
+};
+
+#endif //_PERSISTENT_BUFFER_H
@@ -0,0 +1,621 @@
+/*
+Title: AABB-3D
+File Name: Physics.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PHYSICS_CPP
+#define _PHYSICS_CPP
+
+#include "Physics.h"
+#include "SweepAndPrune.h"
+#include <algorithm>
+#include <cfloat>
+
+// How many objects each job takes in the phases that are spread across threads. Too few and the threads spend their time handing out jobs, too many and
+// there aren't enough jobs to keep every thread busy. This has to be a multiple of 8, so that integration jobs line up with the motion store's blocks.
+static const int OBJECTS_PER_JOB = 512;
+
+// How many islands each collision response job takes. Most islands with any collisions in them only have a couple, so this is a lot smaller than the
+// number of objects per job.
+static const int ISLANDS_PER_JOB = 64;
+
+// How many rays each ray casting job takes. This is a multiple of the packet size, so only the last packet of a batch is ever partly empty.
+static const int RAYS_PER_JOB = 64;
+
+bool TestAABB(const AABB& a, const AABB& b)
+{
+	// If any axis is separated, exit with no intersection.
+	if (a.max.x < b.min.x || a.min.x > b.max.x) return false;
+	if (a.max.y < b.min.y || a.min.y > b.max.y) return false;
+	if (a.max.z < b.min.z || a.min.z > b.max.z) return false;
+
+	return true;
+}
+
+bool SweepAABB(const AABB& a, const glm::vec3& velocityA, const AABB& b, const glm::vec3& velocityB, float dt, SweepResult& result)
+{
+	// If the boxes already overlap, they collide right away. Pick the axis with the least overlap, since that's the shortest way out.
+	if (TestAABB(a, b))
+	{
+		float leastOverlap = FLT_MAX;
+
+		for (int i = 0; i < 3; i++)
+		{
+			float overlap = std::min(a.max[i] - b.min[i], b.max[i] - a.min[i]);
+
+			if (overlap < leastOverlap)
+			{
+				leastOverlap = overlap;
+				result.axis = i;
+			}
+		}
+
+		// Point the normal from a's center towards b's center.
+		result.normal = glm::vec3(0.0f);
+		result.normal[result.axis] = (a.min[result.axis] + a.max[result.axis]) <= (b.min[result.axis] + b.max[result.axis]) ? 1.0f : -1.0f;
+		result.time = 0.0f;
+
+		return true;
+	}
+
+	// It's easier to think about one box moving towards a box that's standing still. So we look at things from b's point of view, where a moves by
+	// the difference of the two velocities and b doesn't move at all.
+	glm::vec3 displacement = (velocityA - velocityB) * dt;
+
+	// On each axis, work out when a starts overlapping b (entry) and when it stops (exit), as a fraction of the step.
+	// The boxes only touch when they overlap on all three axes at once, which is from the latest entry to the earliest exit.
+	float entry = -FLT_MAX;
+	float exit = FLT_MAX;
+	int entryAxis = 0;
+
+	for (int i = 0; i < 3; i++)
+	{
+		float axisEntry;
+		float axisExit;
+
+		if (displacement[i] == 0.0f)
+		{
+			// a isn't moving along this axis, so if they don't overlap along it now, they never will.
+			if (a.max[i] < b.min[i] || a.min[i] > b.max[i])
+			{
+				return false;
+			}
+
+			// Otherwise they overlap along this axis for the whole step.
+			continue;
+		}
+		else if (displacement[i] > 0.0f)
+		{
+			axisEntry = (b.min[i] - a.max[i]) / displacement[i];
+			axisExit = (b.max[i] - a.min[i]) / displacement[i];
+		}
+		else
+		{
+			axisEntry = (b.max[i] - a.min[i]) / displacement[i];
+			axisExit = (b.min[i] - a.max[i]) / displacement[i];
+		}
+
+		if (axisEntry > entry)
+		{
+			entry = axisEntry;
+			entryAxis = i;
+		}
+
+		exit = std::min(exit, axisExit);
+	}
+
+	// They miss if they've stopped overlapping along one axis before they start along another, or if they don't touch until after this step.
+	// (entry can't be below zero here, since they didn't overlap at the start.)
+	if (entry > exit || entry < 0.0f || entry > 1.0f)
+	{
+		return false;
+	}
+
+	result.time = entry;
+	result.axis = entryAxis;
+	result.normal = glm::vec3(0.0f);
+	result.normal[entryAxis] = displacement[entryAxis] > 0.0f ? 1.0f : -1.0f;
+
+	return true;
+}
+
+FixedTimestep::FixedTimestep(double physicsStep, int maxStepsPerCall)
+{
+	step = physicsStep;
+	maxSteps = maxStepsPerCall;
+	accumulator = 0.0;
+	droppedTime = 0.0;
+}
+
+int FixedTimestep::Accumulate(double frameTime)
+{
+	accumulator += frameTime;
+
+	// Count how many whole steps fit in the accumulator (up to the limit), and leave the rest in there for next time.
+	int steps = 0;
+	while (accumulator >= step && steps < maxSteps)
+	{
+		accumulator -= step;
+		steps++;
+	}
+
+	// Don't let more than one more batch of steps pile up. Whatever is over that gets dropped (and counted).
+	double maxBacklog = maxSteps * step;
+	if (accumulator > maxBacklog)
+	{
+		droppedTime += accumulator - maxBacklog;
+		accumulator = maxBacklog;
+	}
+
+	return steps;
+}
+
+PhysicsWorld::PhysicsWorld()
+{
+	broadphase = new SweepAndPrune();
+	useBounds = false;
+	bounds = glm::vec3(0.0f);
+	profiler = nullptr;
+	jobs = nullptr;
+
+	sleepEnabled = true;
+	sleepLinearThreshold = 0.05f;
+	sleepAngularThreshold = 0.05f;
+	stepsToSleep = 60;
+}
+
+PhysicsWorld::~PhysicsWorld()
+{
+	Clear();
+	delete broadphase;
+}
+
+void PhysicsWorld::AddObject(GameObject* object)
+{
+	std::unique_lock<std::shared_timed_mutex> lock(queryMutex);
+
+	object->SetProxy(broadphase->CreateProxy(object->GetAABB(), object));
+	object->AttachMotion(&motion);
+	objects.push_back(object);
+}
+
+void PhysicsWorld::RemoveObject(GameObject* object)
+{
+	std::unique_lock<std::shared_timed_mutex> lock(queryMutex);
+
+	// The object's motion index is also where it is in the objects list, so there's no need to search for it. If it isn't there, it isn't in this world.
+	int index = object->GetMotionIndex();
+
+	if (index < 0 || index >= (int)objects.size() || objects[index] != object)
+	{
+		return;
+	}
+
+	pairCache.RemoveProxy(object->GetProxy());
+	broadphase->DestroyProxy(object->GetProxy());
+	object->SetProxy(-1);
+
+	// Give the object its motion back, and take it out of the store. The store moves its last object into the empty slot, and we do the same in the objects
+	// list, so the two stay in the same order and only the moved object needs its index fixed. This keeps removing an object O(1), which matters when
+	// thousands of them are despawned every second.
+	object->DetachMotion();
+	motion.Remove(index);
+
+	int last = (int)objects.size() - 1;
+	if (index != last)
+	{
+		objects[index] = objects[last];
+		objects[index]->SetMotionIndex(index);
+	}
+
+	objects.pop_back();
+}
+
+void PhysicsWorld::Clear()
+{
+	std::unique_lock<std::shared_timed_mutex> lock(queryMutex);
+
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		broadphase->DestroyProxy(objects[i]->GetProxy());
+		objects[i]->SetProxy(-1);
+		objects[i]->DetachMotion();
+	}
+
+	objects.clear();
+	motion.Clear();
+	pairs.clear();
+	contacts.clear();
+	events.clear();
+	pairCache.Clear();
+}
+
+void PhysicsWorld::SetBroadphase(Broadphase* newBroadphase)
+{
+	std::unique_lock<std::shared_timed_mutex> lock(queryMutex);
+
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		broadphase->DestroyProxy(objects[i]->GetProxy());
+		objects[i]->SetProxy(newBroadphase->CreateProxy(objects[i]->GetAABB(), objects[i]));
+	}
+
+	delete broadphase;
+	broadphase = newBroadphase;
+
+	// Every object has a new proxy ID now, so the pair cache needs to catch up.
+	pairCache.RefreshProxies();
+}
+
+void PhysicsWorld::SetSleeping(bool enabled)
+{
+	sleepEnabled = enabled;
+
+	if (!enabled)
+	{
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			objects[i]->Wake();
+		}
+	}
+}
+
+bool PhysicsWorld::Respond(int i, float dt)
+{
+	// Only respond when two objects first touch. If they're still overlapping next step, they're already on their way apart, and bouncing them again would
+	// just send them back into each other.
+	// The BEGIN and STAY events come out in the same order as the contacts, so events[i] goes with sweeps[i].
+	if (events[i].type != PairEvent::BEGIN)
+	{
+		return false;
+	}
+
+	const SweepResult& sweep = sweeps[i];
+	GameObject* pairObjects[2] = { events[i].pair.objectA, events[i].pair.objectB };
+	bool wokeUp = pairObjects[0]->IsAsleep() || pairObjects[1]->IsAsleep();
+
+	// Getting hit wakes a sleeping object up (and keeps an awake one from dozing off).
+	pairObjects[0]->Wake();
+	pairObjects[1]->Wake();
+
+	// The normal points from A towards B, so B has to use the opposite direction.
+	glm::vec3 normals[2] = { sweep.normal, -sweep.normal };
+
+	for (int k = 0; k < 2; k++)
+	{
+		glm::vec3 velocity = pairObjects[k]->GetVelocity();
+
+		// Reverse the velocity along the axis of the collision, but only if the object is moving towards the other one along it. (If it's already
+		// moving away, or not moving at all, it can stay that way.)
+		if (glm::dot(velocity, normals[k]) <= 0.0f)
+		{
+			continue;
+		}
+
+		glm::vec3 bounced = velocity;
+		bounced[sweep.axis] *= -1.0f;
+		pairObjects[k]->SetVelocity(bounced);
+
+		// The object should only travel with its old velocity until the moment of impact, and with the new one for the rest of the step. Update moves it
+		// by the new velocity for the whole step, so we make up the difference here.
+		pairObjects[k]->AddPosition((velocity - bounced) * (sweep.time * dt));
+	}
+
+	return wokeUp;
+}
+
+void PhysicsWorld::Step(float dt)
+{
+	std::unique_lock<std::shared_timed_mutex> lock(queryMutex);
+	ScopedTimer stepTimer(profiler, PROFILE_STEP);
+
+	// This section just checks to make sure the objects stay within a certain boundary. This is not really collision detection.
+	if (useBounds)
+	{
+		ScopedTimer timer(profiler, PROFILE_BOUNDS);
+
+		ParallelFor(jobs, (int)objects.size(), OBJECTS_PER_JOB, [this](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				// A sleeping object isn't going anywhere.
+				if (objects[i]->IsAsleep())
+				{
+					continue;
+				}
+
+				glm::vec3 tempPos = objects[i]->GetPosition();
+				glm::vec3 tempVel = objects[i]->GetVelocity();
+				bool bounced = false;
+
+				// "Bounce" the velocity along any axis that was over-extended.
+				for (int axis = 0; axis < 3; axis++)
+				{
+					if (fabsf(tempPos[axis]) > bounds[axis])
+					{
+						tempVel[axis] *= -1.0f;
+						bounced = true;
+					}
+				}
+
+				// Only set the velocity if it changed, since setting it counts as the object being disturbed.
+				if (bounced)
+				{
+					objects[i]->SetVelocity(tempVel);
+				}
+			}
+		});
+	}
+
+	// Re-calculate the Axis-Aligned Bounding Box for each object. (GetAABB only re-calculates the box if the object has moved, rotated or scaled since the
+	// last time it was asked for.)
+	// We do this because if the object's orientation changes, we should update the bounding box as well.
+	// Every object only touches its own matrices and box here, so the objects can be split up between threads without changing the results.
+	{
+		ScopedTimer timer(profiler, PROFILE_CALCULATE_AABB);
+
+		ParallelFor(jobs, (int)objects.size(), OBJECTS_PER_JOB, [this](int begin, int end)
+		{
+			for (int i = begin; i < end; i++)
+			{
+				if (!objects[i]->IsAsleep())
+				{
+					objects[i]->GetAABB();
+				}
+			}
+		});
+	}
+
+	// Hand the new boxes to the broadphase, and ask it which objects are close enough to possibly be colliding. Testing every object against every other
+	// object would be O(n^2), which is far too slow once there are thousands of objects.
+	// Each box is stretched to cover everywhere the object will be during this step, so that the broadphase still finds pairs that only touch partway
+	// through the step (which the swept test in the narrowphase needs).
+	{
+		ScopedTimer timer(profiler, PROFILE_BROADPHASE);
+
+		for (size_t i = 0; i < objects.size(); i++)
+		{
+			// A sleeping object's box is exactly where it was last step, so its proxy can stay put.
+			if (objects[i]->IsAsleep())
+			{
+				continue;
+			}
+
+			AABB box = objects[i]->GetAABB();
+			glm::vec3 displacement = objects[i]->GetVelocity() * dt;
+
+			AABB swept;
+			swept.min = glm::min(box.min, box.min + displacement);
+			swept.max = glm::max(box.max, box.max + displacement);
+
+			broadphase->MoveProxy(objects[i]->GetProxy(), swept);
+		}
+
+		broadphase->FindPairs(pairs, jobs);
+	}
+
+	// Now run the actual collision test (the narrowphase) on only those pairs. The swept test tells us when during the step each pair first touches, and
+	// along which axis, so even a fast object is caught the moment it reaches another one instead of after it has already passed through.
+	{
+		ScopedTimer timer(profiler, PROFILE_NARROWPHASE);
+
+		contacts.clear();
+		sweeps.clear();
+
+		for (size_t i = 0; i < pairs.size(); i++)
+		{
+			GameObject* objectA = pairs[i].objectA;
+			GameObject* objectB = pairs[i].objectB;
+
+			SweepResult sweep;
+			if (SweepAABB(objectA->GetAABB(), objectA->GetVelocity(), objectB->GetAABB(), objectB->GetVelocity(), dt, sweep))
+			{
+				contacts.push_back(pairs[i]);
+				sweeps.push_back(sweep);
+			}
+		}
+	}
+
+	// Group the objects into islands, using only the pairs that actually collided, and sort those collisions into them. The broadphase pairs would also link
+	// up objects that are merely near each other (the swept boxes cover the whole step's movement), which makes the islands bigger than they need to be: a
+	// sleeping pile could be woken up, or kept awake, by something that only flew past it.
+	{
+		ScopedTimer timer(profiler, PROFILE_ISLANDS);
+
+		islands.Build((int)objects.size(), contacts);
+		islands.AssignPairs(contacts);
+	}
+
+	{
+		ScopedTimer timer(profiler, PROFILE_RESPONSE);
+
+		// Compare this step's collisions with last step's, so we know which ones just started.
+		pairCache.Update(contacts, events);
+
+		// Every collision only changes the two objects in it, and both of those are in the same island, so each island can be handled on its own thread
+		// without any locks. Within an island, the collisions are handled in the same order as they would be all on one thread, so the results don't
+		// depend on how many threads there are.
+		const std::vector<int>& pairedIslands = islands.GetPairedIslands();
+
+		ParallelFor(jobs, (int)pairedIslands.size(), ISLANDS_PER_JOB, [this, &pairedIslands, dt](int begin, int end)
+		{
+			for (int n = begin; n < end; n++)
+			{
+				int island = pairedIslands[n];
+				const int* islandContacts = islands.IslandPairs(island);
+				int count = islands.IslandPairCount(island);
+				bool wokeUp = false;
+
+				for (int c = 0; c < count; c++)
+				{
+					if (Respond(islandContacts[c], dt))
+					{
+						wokeUp = true;
+					}
+				}
+
+				// If a collision woke up part of a sleeping island (like the bottom of a pile that just got hit), the whole island wakes up with it.
+				// Otherwise everything resting on the woken objects would stay frozen where it is until something hit it too.
+				if (wokeUp)
+				{
+					const int* members = islands.IslandObjects(island);
+					int size = islands.IslandSize(island);
+
+					for (int k = 0; k < size; k++)
+					{
+						objects[members[k]]->Wake();
+					}
+				}
+			}
+		});
+	}
+
+	// Move everything forward by dt. This does the same thing as calling Update on every object, but all at once over the packed arrays in the motion store.
+	// The objects' translation matrices are left alone here. Each object catches its own up the next time its transform or AABB is asked for.
+	{
+		ScopedTimer timer(profiler, PROFILE_INTEGRATE);
+
+		MotionStore* store = &motion;
+		ParallelFor(jobs, motion.Size(), OBJECTS_PER_JOB, [store, dt](int begin, int end)
+		{
+			store->IntegrateRange(dt, begin, end);
+		});
+
+		motion.MarkMoved();
+	}
+
+	// Now that everything has moved, check which objects have come to rest. An island only goes to sleep once every object in it has been resting long
+	// enough, and then all of them go to sleep together. Each island only looks at its own objects, so the islands can be split up between threads. (Most
+	// islands are a single object, so they're handed out in the same sized chunks as the per-object phases.)
+	if (sleepEnabled)
+	{
+		ScopedTimer timer(profiler, PROFILE_SLEEP);
+
+		float linearThreshold = sleepLinearThreshold;
+		float angularThreshold = sleepAngularThreshold;
+		int steps = stepsToSleep;
+		ParallelFor(jobs, islands.NumIslands(), OBJECTS_PER_JOB, [this, dt, linearThreshold, angularThreshold, steps](int begin, int end)
+		{
+			for (int island = begin; island < end; island++)
+			{
+				const int* members = islands.IslandObjects(island);
+				int count = islands.IslandSize(island);
+				bool resting = true;
+
+				// Every object has to keep counting how long it's been resting, so we don't stop at the first one that isn't.
+				for (int k = 0; k < count; k++)
+				{
+					if (!objects[members[k]]->UpdateSleep(dt, linearThreshold, angularThreshold, steps))
+					{
+						resting = false;
+					}
+				}
+
+				if (!resting)
+				{
+					continue;
+				}
+
+				for (int k = 0; k < count; k++)
+				{
+					if (!objects[members[k]]->IsAsleep())
+					{
+						objects[members[k]]->Sleep();
+					}
+				}
+			}
+		});
+	}
+}
+
+void PhysicsWorld::CastRays(const Ray* rays, int count, RayHit* closest, std::vector<RayHit>* all, JobSystem* rayJobs)
+{
+	std::shared_lock<std::shared_timed_mutex> lock(queryMutex);
+
+	// Every chunk of rays gets its own query, so the threads never share anything they write to. (A job can be handed more than one chunk, if there
+	// aren't any other threads to share them with.)
+	Broadphase* rayBroadphase = broadphase;
+	ParallelFor(rayJobs, count, RAYS_PER_JOB, [rays, closest, all, rayBroadphase](int begin, int end)
+	{
+		PreparedRay prepared[RAYS_PER_JOB];
+
+		for (int first = begin; first < end; first += RAYS_PER_JOB)
+		{
+			int numRays = std::min(RAYS_PER_JOB, end - first);
+
+			for (int i = 0; i < numRays; i++)
+			{
+				prepared[i] = PreparedRay(rays[first + i]);
+			}
+
+			if (closest != nullptr)
+			{
+				RayQuery query(prepared, numRays, closest + first);
+				rayBroadphase->CastRays(query);
+			}
+			else
+			{
+				RayQuery query(prepared, numRays, all + first);
+				rayBroadphase->CastRays(query);
+				query.Finish();
+			}
+		}
+	});
+}
+
+bool PhysicsWorld::RayCast(const Ray& ray, RayHit& hit)
+{
+	CastRays(&ray, 1, &hit, nullptr, nullptr);
+	return hit.object != nullptr;
+}
+
+void PhysicsWorld::RayCastAll(const Ray& ray, std::vector<RayHit>& hits)
+{
+	CastRays(&ray, 1, nullptr, &hits, nullptr);
+}
+
+void PhysicsWorld::RayCast(const Ray* rays, int count, RayHit* hits, JobSystem* rayJobs)
+{
+	CastRays(rays, count, hits, nullptr, rayJobs);
+}
+
+void PhysicsWorld::RayCastAll(const Ray* rays, int count, std::vector<RayHit>* hits, JobSystem* rayJobs)
+{
+	CastRays(rays, count, nullptr, hits, rayJobs);
+}
+
+#endif // _PHYSICS_CPP
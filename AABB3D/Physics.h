@@ -0,0 +1,280 @@
+/*
+Title: AABB-3D
+File Name: Physics.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PHYSICS_H
+#define _PHYSICS_H
+
+#include "GameObject.h"
+#include "Broadphase.h"
+#include "Profiler.h"
+#include "PairCache.h"
+#include "MotionStore.h"
+#include "JobSystem.h"
+#include "IslandBuilder.h"
+#include "RayQuery.h"
+#include <vector>
+#include <shared_mutex>
+
+// Regular AABB collision detection. This is our narrowphase test, which runs on every pair the broadphase hands back.
+bool TestAABB(const AABB& a, const AABB& b);
+
+// When and where two moving boxes first touch, as worked out by SweepAABB.
+struct SweepResult
+{
+	// When the boxes first touch, from 0 (the start of the step) to 1 (the end of the step).
+	float time;
+
+	// The axis the boxes touch along (0 = x, 1 = y, 2 = z), and the direction from the first box to the second along that axis.
+	int axis;
+	glm::vec3 normal;
+};
+
+// Swept AABB collision detection. Moves box a by velocityA * dt and box b by velocityB * dt, and finds the first moment during that time that they touch.
+// Unlike TestAABB, which only looks at where the boxes are at the end of a step, this can't miss a fast object that passes all the way through another one
+// in a single step (which is called tunneling).
+// If the boxes already overlap at the start, the time is 0 and the axis is the one they overlap the least along (the quickest way to push them apart).
+// Returns false if the boxes don't touch at any point during the step.
+bool SweepAABB(const AABB& a, const glm::vec3& velocityA, const AABB& b, const glm::vec3& velocityB, float dt, SweepResult& result);
+
+// Keeps track of how much real time has passed and turns it into a whole number of fixed physics steps.
+// The accumulator is here so that we can track the amount of time that needs to be updated based on frame time, but not actually update at those intervals and
+// instead always use our physics step. Any leftover time is saved for next time.
+class FixedTimestep
+{
+	double step;
+	int maxSteps;
+	double accumulator;
+
+	// The total amount of time that was thrown away because the accumulator was too far behind.
+	double droppedTime;
+
+public:
+	FixedTimestep(double physicsStep, int maxStepsPerCall = 8);
+
+	// Adds the given amount of time to the accumulator and returns how many physics steps should be run now.
+	// No more than maxStepsPerCall steps are handed out at once, so that if we experience any sort of delay (the window is being moved, a breakpoint was hit,
+	// etc.) we don't go away to run a huge number of steps all at once. Whatever time is left over stays in the accumulator, and the simulation catches back up
+	// over the next few calls.
+	// The leftover time is capped at one more batch (maxStepsPerCall steps) though. If the steps themselves take longer than the time they simulate, we could
+	// never catch up: every batch would take long enough to owe an even bigger one, and the simulation would grind to a halt (the "spiral of death"). Anything
+	// over the cap is dropped, so the simulation runs slower than real time instead, and the dropped time is added up in GetDroppedTime.
+	int Accumulate(double frameTime);
+
+	double GetStep()
+	{
+		return step;
+	}
+
+	// How far we are between the last step and the next one, from 0 to 1. If we're still catching up (there's more than a whole step left in the
+	// accumulator) this is 1.
+	double GetAlpha()
+	{
+		return accumulator < step ? accumulator / step : 1.0;
+	}
+
+	// True if there's at least one more whole step waiting in the accumulator, because the last call hit its limit.
+	bool IsBehind()
+	{
+		return accumulator >= step;
+	}
+
+	// The total amount of time (in seconds) that has been dropped so far, because the simulation fell too far behind to catch up. If this keeps going up,
+	// the physics steps are too slow to run in real time.
+	double GetDroppedTime()
+	{
+		return droppedTime;
+	}
+};
+
+// Holds every simulated GameObject and runs the physics step on them. None of this needs OpenGL, so it can run with no window at all.
+// The world doesn't own the GameObjects, it just keeps pointers to them. So make sure they are stored and cleaned up elsewhere!
+class PhysicsWorld
+{
+	std::vector<GameObject*> objects;
+
+	// The position, velocity and acceleration of every object, packed together so that the whole world can be integrated in one pass. Objects are kept in
+	// the same order here as in the objects list, so objects[i] is always at index i.
+	MotionStore motion;
+
+	// The world does own its broadphase.
+	Broadphase* broadphase;
+
+	// The list of possibly colliding pairs that the broadphase hands back every physics step. We keep it around so it doesn't have to reallocate every step.
+	std::vector<BroadphasePair> pairs;
+
+	// The pairs that actually collide this step, after the narrowphase, and when and along which axis each of them collides.
+	std::vector<BroadphasePair> contacts;
+	std::vector<SweepResult> sweeps;
+
+	// Remembers which pairs were colliding last step, so that we only respond to a collision once (when it begins) instead of every step the objects are still
+	// overlapping. This is what keeps objects from getting stuck inside each other due to tunneling or recalculating of the AABB.
+	PairCache pairCache;
+
+	// What happened to each colliding pair this step.
+	std::vector<PairEvent> events;
+
+	// The groups of objects that are touching each other this step (going by the pairs that collided). Collisions are handled one island at a time, and
+	// objects are put to sleep one island at a time.
+	IslandBuilder islands;
+
+	// If useBounds is true, objects bounce off the walls of a box centered on the origin with the given half size.
+	bool useBounds;
+	glm::vec3 bounds;
+
+	// If set, each phase of the step is timed with this. The world doesn't own it.
+	Profiler* profiler;
+
+	// If set, the phases that work on each object (or island) separately (the bounds check, recalculating the AABBs, finding pairs, collision response,
+	// integrating, and sleeping) are spread across every thread of this job system. The world doesn't own it.
+	JobSystem* jobs;
+
+	// If sleeping is on, objects that have been moving slower than sleepLinearThreshold (units per second) and rotating slower than sleepAngularThreshold
+	// (radians per second) for stepsToSleep steps in a row are put to sleep. Sleeping objects aren't integrated, don't have their AABBs recalculated, and
+	// aren't moved in the broadphase, so a big pile of objects at rest costs very little. They wake up when something collides with them.
+	bool sleepEnabled;
+	float sleepLinearThreshold;
+	float sleepAngularThreshold;
+	int stepsToSleep;
+
+	// Ray casts can come from other threads (like the render thread picking an object under the mouse), while the physics thread is busy stepping. Any
+	// number of ray casts can share this lock, but stepping (or adding or removing objects) needs it all to itself, so a ray cast never sees the world
+	// halfway through a step.
+	std::shared_timed_mutex queryMutex;
+
+	// Bounces the two objects of contacts[i] off of each other, if they just started touching. Returns true if that woke up an object that was asleep.
+	bool Respond(int i, float dt);
+
+	// Casts count rays through the broadphase, keeping either the closest hit of each one (in closest) or every hit (in all).
+	void CastRays(const Ray* rays, int count, RayHit* closest, std::vector<RayHit>* all, JobSystem* rayJobs);
+
+public:
+	PhysicsWorld();
+	~PhysicsWorld();
+
+	// Adds an object to the world. Its AABB is calculated and it is registered with the broadphase, so set up its transform first.
+	// Its position, velocity and acceleration are moved into the world's motion store until it is removed again.
+	void AddObject(GameObject* object);
+	void RemoveObject(GameObject* object);
+
+	// Removes every object from the world (without deleting them).
+	void Clear();
+
+	// Swaps in a different broadphase. The world takes ownership of it, and every object is moved over.
+	void SetBroadphase(Broadphase* newBroadphase);
+	Broadphase* GetBroadphase()
+	{
+		return broadphase;
+	}
+
+	void SetBounds(const glm::vec3& halfSize)
+	{
+		useBounds = true;
+		bounds = halfSize;
+	}
+
+	void SetProfiler(Profiler* p)
+	{
+		profiler = p;
+	}
+
+	void SetJobSystem(JobSystem* j)
+	{
+		jobs = j;
+	}
+	JobSystem* GetJobSystem()
+	{
+		return jobs;
+	}
+
+	// Turning sleeping off wakes every object up.
+	void SetSleeping(bool enabled);
+	bool GetSleeping()
+	{
+		return sleepEnabled;
+	}
+	void SetSleepThresholds(float linearThreshold, float angularThreshold, int steps)
+	{
+		sleepLinearThreshold = linearThreshold;
+		sleepAngularThreshold = angularThreshold;
+		stepsToSleep = steps;
+	}
+
+	std::vector<GameObject*>& GetObjects()
+	{
+		return objects;
+	}
+	const std::vector<BroadphasePair>& GetPairs()
+	{
+		return pairs;
+	}
+
+	// Every pair that began, stayed, or ended colliding during the last step.
+	const std::vector<PairEvent>& GetEvents()
+	{
+		return events;
+	}
+
+	// The islands from the last step.
+	const IslandBuilder& GetIslands()
+	{
+		return islands;
+	}
+
+	// Runs one physics step of dt seconds.
+	void Step(float dt);
+
+	// Ray casts against the objects' AABBs (the boxes from the last step, the same ones the collision tests used).
+	// These can be called from any thread, and from several at once. If a step is running, they wait for it to finish first.
+
+	// Fills hit with the closest object the ray hits, and returns true, or returns false if it doesn't hit anything.
+	bool RayCast(const Ray& ray, RayHit& hit);
+
+	// Fills hits with every object the ray hits, sorted from closest to farthest.
+	void RayCastAll(const Ray& ray, std::vector<RayHit>& hits);
+
+	// Casts a whole batch of rays at once, and fills hits[i] with the closest hit of rays[i] (with a null object if it didn't hit anything). This is much
+	// faster than casting them one at a time, since the broadphase can test several rays against each box at once. If a job system is given, the rays are
+	// split up between its threads.
+	void RayCast(const Ray* rays, int count, RayHit* hits, JobSystem* rayJobs = nullptr);
+
+	// Same as above, but fills hits[i] with every hit of rays[i], sorted from closest to farthest.
+	void RayCastAll(const Ray* rays, int count, std::vector<RayHit>* hits, JobSystem* rayJobs = nullptr);
+};
+
+#endif //_PHYSICS_H
@@ -0,0 +1,229 @@
+/*
+Title: AABB-3D
+File Name: PhysicsThread.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PHYSICS_THREAD_CPP
+#define _PHYSICS_THREAD_CPP
+
+#include "PhysicsThread.h"
+
+typedef std::chrono::steady_clock Clock;
+
+PhysicsThread::PhysicsThread(PhysicsWorld* physicsWorld, double physicsStep)
+{
+	world = physicsWorld;
+	step = physicsStep;
+	running = false;
+	droppedTime = 0.0;
+	hasSnapshot = false;
+}
+
+PhysicsThread::~PhysicsThread()
+{
+	Stop();
+}
+
+void PhysicsThread::Start(std::function<void(float)> function)
+{
+	if (running)
+	{
+		return;
+	}
+
+	if (function)
+	{
+		stepFunction = function;
+	}
+	else
+	{
+		PhysicsWorld* w = world;
+		stepFunction = [w](float dt) { w->Step(dt); };
+	}
+
+	running = true;
+	thread = std::thread(&PhysicsThread::Run, this);
+}
+
+void PhysicsThread::Stop()
+{
+	running = false;
+
+	if (thread.joinable())
+	{
+		thread.join();
+	}
+}
+
+// Copies the transform of every object in the world into the given list.
+void PhysicsThread::CaptureState(std::vector<TransformState>& state)
+{
+	std::vector<GameObject*>& objects = world->GetObjects();
+	state.resize(objects.size());
+
+	// GetTransform rebuilds the matrix of any object that moved, so this is worth spreading across the world's job system (if it has one).
+	ParallelFor(world->GetJobSystem(), (int)objects.size(), 512, [&objects, &state](int begin, int end)
+	{
+		for (int i = begin; i < end; i++)
+		{
+			// The translation is the last column of the transformation matrix.
+			state[i].position = glm::vec3((*objects[i]->GetTransform())[3]);
+			state[i].orientation = glm::quat_cast(objects[i]->GetRotation());
+			state[i].scale = objects[i]->GetScale();
+		}
+	});
+}
+
+// Copies the model of every object in the world into the given list.
+void PhysicsThread::CaptureModels(std::vector<Model*>& models)
+{
+	std::vector<GameObject*>& objects = world->GetObjects();
+	models.resize(objects.size());
+
+	for (size_t i = 0; i < objects.size(); i++)
+	{
+		models[i] = objects[i]->GetModel();
+	}
+}
+
+// This is the loop that runs on the physics thread.
+void PhysicsThread::Run()
+{
+	FixedTimestep timestep(step);
+
+	// Publish the starting state, so the renderer has something to draw right away.
+	PhysicsSnapshot& first = snapshots.WriteBuffer();
+	CaptureState(first.current);
+	CaptureModels(first.models);
+	first.previous = first.current;
+	first.alpha = 0.0;
+	first.publishTime = Clock::now();
+	snapshots.Publish();
+
+	Clock::time_point previousTime = Clock::now();
+
+	while (running)
+	{
+		Clock::time_point now = Clock::now();
+		double frameTime = std::chrono::duration<double>(now - previousTime).count();
+		previousTime = now;
+
+		int steps = timestep.Accumulate(frameTime);
+		droppedTime = timestep.GetDroppedTime();
+
+		if (steps > 0)
+		{
+			PhysicsSnapshot& snapshot = snapshots.WriteBuffer();
+
+			for (int i = 0; i < steps; i++)
+			{
+				// We only need the state from right before the final step, since we only ever blend between the last two steps.
+				if (i == steps - 1)
+				{
+					CaptureState(snapshot.previous);
+				}
+
+				stepFunction((float)step);
+			}
+
+			CaptureState(snapshot.current);
+			CaptureModels(snapshot.models);
+			snapshot.alpha = timestep.GetAlpha();
+			snapshot.publishTime = Clock::now();
+			snapshots.Publish();
+		}
+
+		// If we're behind, go straight back around to run the next batch of steps.
+		if (timestep.IsBehind())
+		{
+			continue;
+		}
+
+		// Sleep until the next step is due, instead of spinning and eating up a whole CPU core.
+		std::this_thread::sleep_for(std::chrono::duration<double>((1.0 - timestep.GetAlpha()) * step));
+	}
+}
+
+bool PhysicsThread::Interpolate(std::vector<glm::mat4>& transforms, std::vector<Model*>* models)
+{
+	if (snapshots.Update())
+	{
+		hasSnapshot = true;
+	}
+
+	if (!hasSnapshot)
+	{
+		return false;
+	}
+
+	const PhysicsSnapshot& snapshot = snapshots.ReadBuffer();
+
+	// Work out how far we are between the two states. The snapshot tells us how far along we already were when it was published, and on top of that we add
+	// however much time has passed since then. We don't go past the current state, since we'd be guessing where things are headed.
+	double alpha = snapshot.alpha + std::chrono::duration<double>(Clock::now() - snapshot.publishTime).count() / step;
+	if (alpha > 1.0)
+	{
+		alpha = 1.0;
+	}
+	float a = (float)alpha;
+
+	transforms.resize(snapshot.current.size());
+
+	if (models)
+	{
+		*models = snapshot.models;
+	}
+
+	for (size_t i = 0; i < snapshot.current.size(); i++)
+	{
+		const TransformState& current = snapshot.current[i];
+
+		// An object that was just added won't have a previous state, so just use its current one.
+		const TransformState& previous = i < snapshot.previous.size() ? snapshot.previous[i] : current;
+
+		glm::vec3 position = glm::mix(previous.position, current.position, a);
+		glm::quat orientation = glm::slerp(previous.orientation, current.orientation, a);
+		glm::vec3 scale = glm::mix(previous.scale, current.scale, a);
+
+		// Build the transformation matrix the same way GameObject does: translation, then rotation, then scale.
+		transforms[i] = glm::translate(glm::mat4(), position) * glm::toMat4(orientation) * glm::scale(glm::mat4(), scale);
+	}
+
+	return true;
+}
+
+#endif // _PHYSICS_THREAD_CPP
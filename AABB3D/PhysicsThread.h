@@ -0,0 +1,128 @@
+/*
+Title: AABB-3D
+File Name: PhysicsThread.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PHYSICS_THREAD_H
+#define _PHYSICS_THREAD_H
+
+#include "Physics.h"
+#include "TripleBuffer.h"
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <functional>
+#include <chrono>
+
+// The parts of an object's transform that we can smoothly blend between two physics steps.
+struct TransformState
+{
+	glm::vec3 position;
+	glm::quat orientation;
+	glm::vec3 scale;
+};
+
+// What the physics thread hands to the render thread after it runs: the transforms of every object after the last two physics steps.
+struct PhysicsSnapshot
+{
+	std::vector<TransformState> previous;
+	std::vector<TransformState> current;
+
+	// The model each object is drawn with, in the same order as current.
+	std::vector<Model*> models;
+
+	// How far past the current state the simulation clock had already gotten when this was published, from 0 to 1 of a physics step. (This is the leftover
+	// time in the accumulator.)
+	double alpha;
+
+	// The real time that this snapshot was published.
+	std::chrono::steady_clock::time_point publishTime;
+};
+
+// Runs the physics on its own thread at a fixed physics step, so that slow rendering (or waiting on glfwSwapBuffers) can't hold up the simulation, and a slow
+// physics step can't hold up the rendering.
+// After each batch of steps, the transforms of every object are handed to the render thread through a triple buffer. The render thread then blends between
+// the last two physics states based on how much time has passed since, so that motion looks smooth even though the physics step doesn't line up with the frames.
+// While the thread is running, the physics thread is the only one allowed to touch the world or its GameObjects.
+class PhysicsThread
+{
+	PhysicsWorld* world;
+	double step;
+
+	// The function run once per physics step (on the physics thread). This is world->Step by default.
+	std::function<void(float)> stepFunction;
+
+	std::thread thread;
+	std::atomic<bool> running;
+
+	// How much time the physics thread has dropped because it fell too far behind (see FixedTimestep::Accumulate). Written by the physics thread, read by
+	// anyone.
+	std::atomic<double> droppedTime;
+
+	TripleBuffer<PhysicsSnapshot> snapshots;
+
+	// Only used by the render thread. True once the first snapshot has been picked up.
+	bool hasSnapshot;
+
+	void Run();
+	void CaptureState(std::vector<TransformState>& state);
+	void CaptureModels(std::vector<Model*>& models);
+
+public:
+	PhysicsThread(PhysicsWorld* physicsWorld, double physicsStep);
+	~PhysicsThread();
+
+	// Starts running the physics. If a step function is given it gets called for every step instead of world->Step, so that it can do extra work (like
+	// rotating the demo objects) before stepping the world itself.
+	void Start(std::function<void(float)> function = nullptr);
+
+	// Stops the physics thread and waits for it to finish its current step.
+	void Stop();
+
+	// Render thread: fills transforms with the transformation matrix of every object, blended between the last two physics steps.
+	// If models is given, it is filled with the model of each object, in the same order.
+	// Returns false if the physics thread hasn't published anything yet.
+	bool Interpolate(std::vector<glm::mat4>& transforms, std::vector<Model*>* models = nullptr);
+
+	// The total amount of time (in seconds) that the simulation has dropped so far, because the physics steps couldn't keep up with real time.
+	double GetDroppedTime()
+	{
+		return droppedTime;
+	}
+};
+
+#endif //_PHYSICS_THREAD_H
@@ -0,0 +1,265 @@
+/*
+Title: AABB-3D
+File Name: Profiler.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PROFILER_CPP
+#define _PROFILER_CPP
+
+#include "Profiler.h"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+
+const char* ProfilePhaseName(ProfilePhase phase)
+{
+	switch (phase)
+	{
+	case PROFILE_INTEGRATE:
+		return "Integrate";
+	case PROFILE_CALCULATE_AABB:
+		return "CalculateAABB";
+	case PROFILE_BROADPHASE:
+		return "Broadphase";
+	case PROFILE_NARROWPHASE:
+		return "Narrowphase";
+	case PROFILE_ISLANDS:
+		return "Islands";
+	case PROFILE_RESPONSE:
+		return "Response";
+	case PROFILE_BOUNDS:
+		return "Bounds";
+	case PROFILE_SLEEP:
+		return "Sleep";
+	case PROFILE_STEP:
+		return "Step";
+	case PROFILE_CULL:
+		return "Cull";
+	case PROFILE_RENDER:
+		return "Render";
+	case PROFILE_FRAME:
+		return "Frame";
+	default:
+		return "Unknown";
+	}
+}
+
+Profiler::Profiler()
+{
+	epoch = Clock::now();
+	tracing = false;
+	maxTraceEvents = 0;
+
+	for (int i = 0; i < PROFILE_PHASE_COUNT; i++)
+	{
+		samples[i].reserve(WINDOW_SIZE);
+		nextSample[i] = 0;
+	}
+}
+
+// Must be called with the mutex locked.
+int Profiler::ThreadIndex(std::thread::id id)
+{
+	for (size_t i = 0; i < threads.size(); i++)
+	{
+		if (threads[i] == id)
+		{
+			return (int)i;
+		}
+	}
+
+	threads.push_back(id);
+	return (int)threads.size() - 1;
+}
+
+void Profiler::Record(ProfilePhase phase, Clock::time_point start, Clock::time_point end)
+{
+	double milliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Fill the window up first, then start overwriting the oldest sample.
+	if ((int)samples[phase].size() < WINDOW_SIZE)
+	{
+		samples[phase].push_back(milliseconds);
+	}
+	else
+	{
+		samples[phase][nextSample[phase]] = milliseconds;
+		nextSample[phase] = (nextSample[phase] + 1) % WINDOW_SIZE;
+	}
+
+	if (tracing)
+	{
+		if (trace.size() >= maxTraceEvents)
+		{
+			tracing = false;
+			return;
+		}
+
+		TraceEvent event;
+		event.phase = phase;
+		event.thread = ThreadIndex(std::this_thread::get_id());
+		event.start = std::chrono::duration<double, std::micro>(start - epoch).count();
+		event.duration = std::chrono::duration<double, std::micro>(end - start).count();
+		trace.push_back(event);
+	}
+}
+
+ProfileStats Profiler::GetStats(ProfilePhase phase)
+{
+	std::vector<double> sorted;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		sorted = samples[phase];
+	}
+
+	ProfileStats stats;
+	stats.samples = (int)sorted.size();
+
+	if (sorted.empty())
+	{
+		stats.p50 = 0.0;
+		stats.p99 = 0.0;
+		stats.max = 0.0;
+		return stats;
+	}
+
+	// nth_element only partly sorts the list, just enough to put the requested element where it would be if the list were fully sorted. That's all we need
+	// for a percentile, and it's O(n) instead of O(n log n).
+	size_t median = sorted.size() / 2;
+	size_t high = (sorted.size() * 99) / 100;
+
+	std::nth_element(sorted.begin(), sorted.begin() + median, sorted.end());
+	stats.p50 = sorted[median];
+
+	std::nth_element(sorted.begin(), sorted.begin() + high, sorted.end());
+	stats.p99 = sorted[high];
+
+	stats.max = *std::max_element(sorted.begin(), sorted.end());
+
+	return stats;
+}
+
+void Profiler::Reset()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	for (int i = 0; i < PROFILE_PHASE_COUNT; i++)
+	{
+		samples[i].clear();
+		nextSample[i] = 0;
+	}
+}
+
+void Profiler::StartTrace(size_t maxEvents)
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	trace.clear();
+	maxTraceEvents = maxEvents;
+	tracing = true;
+}
+
+void Profiler::StopTrace()
+{
+	std::lock_guard<std::mutex> lock(mutex);
+
+	tracing = false;
+}
+
+bool Profiler::WriteTrace(const std::string& fileName)
+{
+	std::ofstream file(fileName, std::ios::out);
+
+	if (!file.good())
+	{
+		return false;
+	}
+
+	std::lock_guard<std::mutex> lock(mutex);
+
+	// Every timing is a "complete" event (ph X), which has a start time and a duration. Everything is in microseconds.
+	file << std::fixed << std::setprecision(3);
+	file << "{\"traceEvents\":[" << std::endl;
+
+	for (size_t i = 0; i < trace.size(); i++)
+	{
+		file << "{\"name\":\"" << ProfilePhaseName(trace[i].phase) << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << trace[i].thread
+			<< ",\"ts\":" << trace[i].start << ",\"dur\":" << trace[i].duration << "}";
+
+		if (i + 1 < trace.size())
+		{
+			file << ",";
+		}
+
+		file << std::endl;
+	}
+
+	file << "],\"displayTimeUnit\":\"ms\"}" << std::endl;
+
+	return file.good();
+}
+
+void Profiler::Report(std::ostream& out)
+{
+	std::ios::fmtflags flags = out.flags();
+	std::streamsize precision = out.precision();
+
+	out << std::fixed << std::setprecision(3);
+
+	for (int i = 0; i < PROFILE_PHASE_COUNT; i++)
+	{
+		ProfileStats stats = GetStats((ProfilePhase)i);
+
+		if (stats.samples == 0)
+		{
+			continue;
+		}
+
+		out << std::left << std::setw(16) << ProfilePhaseName((ProfilePhase)i) << std::right
+			<< " p50 " << std::setw(9) << stats.p50 << " ms"
+			<< "   p99 " << std::setw(9) << stats.p99 << " ms"
+			<< "   max " << std::setw(9) << stats.max << " ms" << std::endl;
+	}
+
+	// Put the stream back the way we found it.
+	out.flags(flags);
+	out.precision(precision);
+}
+
+#endif // _PROFILER_CPP
@@ -0,0 +1,186 @@
+/*
+Title: AABB-3D
+File Name: Profiler.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _PROFILER_H
+#define _PROFILER_H
+
+#include <vector>
+#include <string>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <ostream>
+
+// The parts of a frame that get timed. The physics phases are timed once per physics step, and the render phases once per rendered frame.
+enum ProfilePhase
+{
+	PROFILE_INTEGRATE,		// Moving every object forward by dt.
+	PROFILE_CALCULATE_AABB,	// Re-calculating the AABBs of objects that moved.
+	PROFILE_BROADPHASE,		// Updating the broadphase and finding the possibly colliding pairs.
+	PROFILE_NARROWPHASE,	// Running TestAABB on those pairs.
+	PROFILE_ISLANDS,		// Grouping the objects into islands.
+	PROFILE_RESPONSE,		// Bouncing colliding objects off of each other.
+	PROFILE_BOUNDS,			// Bouncing objects off of the walls.
+	PROFILE_SLEEP,			// Putting objects that have come to rest to sleep.
+	PROFILE_STEP,			// The whole physics step, start to finish.
+	PROFILE_CULL,			// Throwing away the objects that are outside the view before drawing.
+	PROFILE_RENDER,			// Drawing the scene.
+	PROFILE_FRAME,			// The whole frame, including waiting on glfwSwapBuffers.
+	PROFILE_PHASE_COUNT
+};
+
+const char* ProfilePhaseName(ProfilePhase phase);
+
+// Timing results for one phase, in milliseconds, over the most recent samples.
+struct ProfileStats
+{
+	double p50;
+	double p99;
+	double max;
+	int samples;
+};
+
+// Collects how long each phase takes. Every phase keeps a rolling window of its most recent timings, which is used to work out the median (p50) and the
+// 99th percentile (p99). The p99 is the one to watch for spikes, since an average hides the odd slow step.
+// It can also record every single timing as a Chrome trace, which can be opened in chrome://tracing (or https://ui.perfetto.dev) to see exactly when each
+// phase ran on each thread.
+// This is safe to use from more than one thread at a time (like the physics thread and the render thread).
+class Profiler
+{
+public:
+	typedef std::chrono::steady_clock Clock;
+
+private:
+	// The number of recent samples each phase keeps for its percentiles.
+	static const int WINDOW_SIZE = 1024;
+
+	struct TraceEvent
+	{
+		ProfilePhase phase;
+		int thread;
+
+		// In microseconds since the profiler was created, which is what the trace format uses.
+		double start;
+		double duration;
+	};
+
+	std::mutex mutex;
+
+	// All trace timestamps are relative to this.
+	Clock::time_point epoch;
+
+	// A ring buffer of durations (in milliseconds) per phase, and where the next one goes.
+	std::vector<double> samples[PROFILE_PHASE_COUNT];
+	int nextSample[PROFILE_PHASE_COUNT];
+
+	bool tracing;
+	size_t maxTraceEvents;
+	std::vector<TraceEvent> trace;
+
+	// Every thread that has recorded something. The index in this list is used as the thread's ID in the trace, since std::thread::id can't be printed as a
+	// number portably.
+	std::vector<std::thread::id> threads;
+
+	int ThreadIndex(std::thread::id id);
+
+	// Not copyable.
+	Profiler(const Profiler&);
+	Profiler& operator=(const Profiler&);
+
+public:
+	Profiler();
+
+	// Records that the given phase ran from start to end on the calling thread. ScopedTimer calls this for you.
+	void Record(ProfilePhase phase, Clock::time_point start, Clock::time_point end);
+
+	ProfileStats GetStats(ProfilePhase phase);
+
+	// Clears every phase's samples (but not the trace).
+	void Reset();
+
+	// Starts recording every timing for the trace. Recording stops on its own after maxEvents, so that leaving it on can't eat up all of your memory.
+	void StartTrace(size_t maxEvents = 1000000);
+	void StopTrace();
+
+	// Writes everything recorded since StartTrace to a file in the Chrome trace event JSON format. Returns false if the file couldn't be written.
+	bool WriteTrace(const std::string& fileName);
+
+	// Prints the p50/p99/max of every phase that has any samples.
+	void Report(std::ostream& out);
+};
+
+// Times the scope it is created in, and hands the result to the profiler when it goes out of scope. If the profiler is null, this does nothing, so code can
+// be left instrumented without a profiler attached.
+// Usage:
+// {
+//     ScopedTimer timer(profiler, PROFILE_BROADPHASE);
+//     ... the code to time ...
+// }
+class ScopedTimer
+{
+	Profiler* profiler;
+	ProfilePhase phase;
+	Profiler::Clock::time_point start;
+
+	// Not copyable.
+	ScopedTimer(const ScopedTimer&);
+	ScopedTimer& operator=(const ScopedTimer&);
+
+public:
+	ScopedTimer(Profiler* p, ProfilePhase timedPhase)
+	{
+		profiler = p;
+		phase = timedPhase;
+
+		if (profiler)
+		{
+			start = Profiler::Clock::now();
+		}
+	}
+
+	~ScopedTimer()
+	{
+		if (profiler)
+		{
+			profiler->Record(phase, start, Profiler::Clock::now());
+		}
+	}
+};
+
+#endif //_PROFILER_H
@@ -0,0 +1,148 @@
+/*
+Title: AABB-3D
+File Name: QuantizedAABB.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _QUANTIZED_AABB_H
+#define _QUANTIZED_AABB_H
+
+#include "AABB.h"
+#include <cmath>
+
+// An AABB squeezed into 16-bit integers: 12 bytes instead of the 24 bytes of an AABB (or 32 of a CalculatorAABB), so more than twice as many fit in a cache
+// line. The values are positions on a grid of 65536 steps per axis laid over some region of the world (see AABBQuantizer).
+// Since a quantized box is always rounded outwards, it's never smaller than the real box. So if two quantized boxes don't overlap, the real boxes don't
+// either. If they do overlap, the real boxes might still not (they could be closer than one grid step apart), so the real TestAABB has to confirm it.
+struct QuantizedAABB
+{
+	unsigned short min[3];
+	unsigned short max[3];
+};
+
+// The quantized version of TestAABB.
+inline bool TestQuantizedAABB(const QuantizedAABB& a, const QuantizedAABB& b)
+{
+	if (a.max[0] < b.min[0] || a.min[0] > b.max[0]) return false;
+	if (a.max[1] < b.min[1] || a.min[1] > b.max[1]) return false;
+	if (a.max[2] < b.min[2] || a.min[2] > b.max[2]) return false;
+
+	return true;
+}
+
+// Turns AABBs into QuantizedAABBs, relative to a region of the world. The region's min is step 0, and its max is step 65535.
+// Boxes (or parts of boxes) outside the region get clamped to its edge. That's still safe (two boxes that really overlap still overlap after clamping), but
+// every box hanging off the same side will look like it overlaps every other one, so pick a region that covers everything if you can.
+class AABBQuantizer
+{
+	glm::vec3 origin;
+	glm::vec3 scale;
+	glm::vec3 inverseScale;
+
+	// Rounds down for a min, and up for a max, and keeps the result inside the 16-bit range.
+	// Both only ever move a value away from the center of the box, which is what makes the quantized box cover the real one. Even in the face of floating
+	// point rounding this holds up, since for any x <= y, Floor(x) <= Ceil(y): the math before rounding is the same for both, and it never changes order.
+	static unsigned short Floor(float value)
+	{
+		value = floorf(value);
+		return (unsigned short)(value < 0.0f ? 0.0f : (value > 65535.0f ? 65535.0f : value));
+	}
+	static unsigned short Ceil(float value)
+	{
+		value = ceilf(value);
+		return (unsigned short)(value < 0.0f ? 0.0f : (value > 65535.0f ? 65535.0f : value));
+	}
+
+public:
+	AABBQuantizer()
+	{
+		SetRegion(AABB(glm::vec3(-1.0f), glm::vec3(1.0f)));
+	}
+	AABBQuantizer(const AABB& region)
+	{
+		SetRegion(region);
+	}
+
+	void SetRegion(const AABB& region)
+	{
+		origin = region.min;
+
+		for (int i = 0; i < 3; i++)
+		{
+			float size = region.max[i] - region.min[i];
+
+			// A flat region would mean dividing by zero, so give it some size.
+			if (!(size > 0.0f))
+			{
+				size = 1.0f;
+			}
+
+			scale[i] = 65535.0f / size;
+			inverseScale[i] = size / 65535.0f;
+		}
+	}
+
+	QuantizedAABB Quantize(const AABB& box) const
+	{
+		QuantizedAABB result;
+
+		for (int i = 0; i < 3; i++)
+		{
+			result.min[i] = Floor((box.min[i] - origin[i]) * scale[i]);
+			result.max[i] = Ceil((box.max[i] - origin[i]) * scale[i]);
+		}
+
+		return result;
+	}
+
+	// Turns a quantized box back into a regular one (the grid steps it covers), which is handy for drawing it.
+	// This is only exact to within floating point rounding, so it can come out a hair smaller than the original box when a side sits right on a grid step.
+	// Overlap tests should always be done on the quantized boxes themselves, which are exact.
+	AABB Dequantize(const QuantizedAABB& box) const
+	{
+		AABB result;
+
+		for (int i = 0; i < 3; i++)
+		{
+			result.min[i] = origin[i] + box.min[i] * inverseScale[i];
+			result.max[i] = origin[i] + box.max[i] * inverseScale[i];
+		}
+
+		return result;
+	}
+};
+
+#endif //_QUANTIZED_AABB_H
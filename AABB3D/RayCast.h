@@ -0,0 +1,264 @@
+/*
+Title: AABB-3D
+File Name: RayCast.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _RAY_CAST_H
+#define _RAY_CAST_H
+
+#include "AABB.h"
+#include "Simd.h"
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+// A ray starting at origin and heading along direction. Distances along the ray are measured in lengths of direction, so the point at distance t is
+// origin + direction * t. (If direction is normalized, that's just the distance in world units.) Nothing past maxDistance counts as a hit.
+struct Ray
+{
+	glm::vec3 origin;
+	glm::vec3 direction;
+	float maxDistance;
+
+	Ray(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, float rayMaxDistance = FLT_MAX)
+	{
+		origin = rayOrigin;
+		direction = rayDirection;
+		maxDistance = rayMaxDistance;
+	}
+	Ray()
+	{
+		origin = glm::vec3(0.0f);
+		direction = glm::vec3(0.0f, 0.0f, 1.0f);
+		maxDistance = FLT_MAX;
+	}
+};
+
+// A ray set up for slab tests.
+// The slab test finds the distances at which the ray crosses the two planes of a box on each axis (its min and its max). The ray is inside the box between
+// the last plane it enters and the first plane it leaves, so if it enters all three slabs before it leaves any of them, it hits the box. Dividing by the
+// direction on every test would be slow, so we store 1 / direction instead and multiply.
+// A direction of exactly zero on an axis would divide by zero, and 0 * infinity gives NaN when the origin sits right on a plane, so those are nudged to a tiny
+// value instead. The inverse is then huge but finite, which gives the right answer on both sides of the plane.
+struct PreparedRay
+{
+	glm::vec3 origin;
+	glm::vec3 inverseDirection;
+	float maxDistance;
+
+	PreparedRay()
+	{
+		origin = glm::vec3(0.0f);
+		inverseDirection = glm::vec3(0.0f);
+		maxDistance = -1.0f;
+	}
+	PreparedRay(const Ray& ray)
+	{
+		origin = ray.origin;
+		maxDistance = ray.maxDistance;
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float d = ray.direction[axis];
+
+			if (fabsf(d) < 1.0e-20f)
+			{
+				d = d < 0.0f ? -1.0e-20f : 1.0e-20f;
+			}
+
+			inverseDirection[axis] = 1.0f / d;
+		}
+	}
+};
+
+// Slab test of one ray against one box, looking no further than reach. If it hits, distance is where the ray enters the box (0 if it starts inside it), and
+// exitDistance is where it leaves (or reach, if that comes first).
+// On each axis the near plane is the min if the ray is heading towards +, and the max if it's heading towards -. Picking the planes this way (instead of
+// taking the min and max of the two distances) means an "empty" box, whose min is past its max, never gets hit.
+inline bool RayTestAABB(const PreparedRay& ray, const AABB& box, float reach, float& distance, float& exitDistance)
+{
+	float tNear = 0.0f;
+	float tFar = reach;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float inverse = ray.inverseDirection[axis];
+		float nearPlane = inverse >= 0.0f ? box.min[axis] : box.max[axis];
+		float farPlane = inverse >= 0.0f ? box.max[axis] : box.min[axis];
+
+		tNear = std::max(tNear, (nearPlane - ray.origin[axis]) * inverse);
+		tFar = std::min(tFar, (farPlane - ray.origin[axis]) * inverse);
+	}
+
+	distance = tNear;
+	exitDistance = tFar;
+	return tNear <= tFar;
+}
+
+inline bool RayTestAABB(const PreparedRay& ray, const AABB& box, float reach, float& distance)
+{
+	float exitDistance;
+	return RayTestAABB(ray, box, reach, distance, exitDistance);
+}
+
+// Up to 8 rays stored as a structure of arrays, so that one box can be tested against all of them at once. Each ray only looks as far as its reach, and
+// unused slots have a reach of -1 so they never hit anything.
+struct RayPacket
+{
+	static const int SIZE = 8;
+
+	float originX[SIZE], originY[SIZE], originZ[SIZE];
+	float inverseX[SIZE], inverseY[SIZE], inverseZ[SIZE];
+	float reach[SIZE];
+
+	// Which ray (in whatever list the packet was filled from) is in each slot.
+	int ray[SIZE];
+	int count;
+
+	RayPacket()
+	{
+		count = 0;
+
+		for (int i = 0; i < SIZE; i++)
+		{
+			originX[i] = originY[i] = originZ[i] = 0.0f;
+			inverseX[i] = inverseY[i] = inverseZ[i] = 1.0f;
+			reach[i] = -1.0f;
+			ray[i] = -1;
+		}
+	}
+
+	void Add(const PreparedRay& prepared, float rayReach, int index)
+	{
+		originX[count] = prepared.origin.x;
+		originY[count] = prepared.origin.y;
+		originZ[count] = prepared.origin.z;
+		inverseX[count] = prepared.inverseDirection.x;
+		inverseY[count] = prepared.inverseDirection.y;
+		inverseZ[count] = prepared.inverseDirection.z;
+		reach[count] = rayReach;
+		ray[count] = index;
+		count++;
+	}
+};
+
+// Slab test of every ray in the packet against one box. Returns a bitmask where bit i is set if ray i hits the box, and fills distances with where each
+// ray enters it.
+// Every ray can be heading a different way here, so instead of picking the near plane by the sign of the direction, this takes the smaller of the two plane
+// distances on each axis as the near one. That gives exactly the same distances as RayTestAABB, but only works on real boxes (min <= max).
+inline unsigned int RayPacketTestAABB(const RayPacket& packet, const AABB& box, float* distances)
+{
+#if defined(PHYSICS_AVX)
+	__m256 tNear = _mm256_setzero_ps();
+	__m256 tFar = _mm256_loadu_ps(packet.reach);
+
+	const float* origins[3] = { packet.originX, packet.originY, packet.originZ };
+	const float* inverses[3] = { packet.inverseX, packet.inverseY, packet.inverseZ };
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		__m256 origin = _mm256_loadu_ps(origins[axis]);
+		__m256 inverse = _mm256_loadu_ps(inverses[axis]);
+		__m256 t1 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.min[axis]), origin), inverse);
+		__m256 t2 = _mm256_mul_ps(_mm256_sub_ps(_mm256_set1_ps(box.max[axis]), origin), inverse);
+
+		tNear = _mm256_max_ps(tNear, _mm256_min_ps(t1, t2));
+		tFar = _mm256_min_ps(tFar, _mm256_max_ps(t1, t2));
+	}
+
+	_mm256_storeu_ps(distances, tNear);
+	return (unsigned int)_mm256_movemask_ps(_mm256_cmp_ps(tNear, tFar, _CMP_LE_OQ));
+#elif defined(PHYSICS_SSE)
+	const float* origins[3] = { packet.originX, packet.originY, packet.originZ };
+	const float* inverses[3] = { packet.inverseX, packet.inverseY, packet.inverseZ };
+
+	unsigned int mask = 0;
+
+	// SSE registers only hold 4 floats, so do the packet in two halves.
+	for (int half = 0; half < 2; half++)
+	{
+		int j = half * 4;
+
+		__m128 tNear = _mm_setzero_ps();
+		__m128 tFar = _mm_loadu_ps(packet.reach + j);
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			__m128 origin = _mm_loadu_ps(origins[axis] + j);
+			__m128 inverse = _mm_loadu_ps(inverses[axis] + j);
+			__m128 t1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.min[axis]), origin), inverse);
+			__m128 t2 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.max[axis]), origin), inverse);
+
+			tNear = _mm_max_ps(tNear, _mm_min_ps(t1, t2));
+			tFar = _mm_min_ps(tFar, _mm_max_ps(t1, t2));
+		}
+
+		_mm_storeu_ps(distances + j, tNear);
+		mask |= (unsigned int)_mm_movemask_ps(_mm_cmple_ps(tNear, tFar)) << j;
+	}
+
+	return mask;
+#else
+	// Plain C++ fallback for CPUs we don't have a vector path for.
+	const float* origins[3] = { packet.originX, packet.originY, packet.originZ };
+	const float* inverses[3] = { packet.inverseX, packet.inverseY, packet.inverseZ };
+
+	unsigned int mask = 0;
+
+	for (int k = 0; k < RayPacket::SIZE; k++)
+	{
+		float tNear = 0.0f;
+		float tFar = packet.reach[k];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float t1 = (box.min[axis] - origins[axis][k]) * inverses[axis][k];
+			float t2 = (box.max[axis] - origins[axis][k]) * inverses[axis][k];
+
+			tNear = std::max(tNear, std::min(t1, t2));
+			tFar = std::min(tFar, std::max(t1, t2));
+		}
+
+		distances[k] = tNear;
+		mask |= (unsigned int)(tNear <= tFar) << k;
+	}
+
+	return mask;
+#endif
+}
+
+#endif //_RAY_CAST_H
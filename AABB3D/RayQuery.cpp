@@ -0,0 +1,122 @@
+/*
+Title: AABB-3D
+File Name: RayQuery.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _RAY_QUERY_CPP
+#define _RAY_QUERY_CPP
+
+#include "RayQuery.h"
+#include <algorithm>
+
+// Hits are ordered by distance. Two hits at exactly the same distance are ordered by proxy ID, so the results don't depend on which order the broadphase
+// happened to find them in.
+static bool HitLess(const RayHit& a, const RayHit& b)
+{
+	return a.distance < b.distance || (a.distance == b.distance && a.object->GetProxy() < b.object->GetProxy());
+}
+
+RayQuery::RayQuery(const PreparedRay* queryRays, int count, RayHit* closestHits)
+{
+	rays = queryRays;
+	numRays = count;
+	closest = closestHits;
+	all = nullptr;
+
+	for (int i = 0; i < numRays; i++)
+	{
+		closest[i] = RayHit();
+	}
+}
+
+RayQuery::RayQuery(const PreparedRay* queryRays, int count, std::vector<RayHit>* allHits)
+{
+	rays = queryRays;
+	numRays = count;
+	closest = nullptr;
+	all = allHits;
+
+	for (int i = 0; i < numRays; i++)
+	{
+		all[i].clear();
+	}
+}
+
+void RayQuery::Candidate(int i, GameObject* object)
+{
+	float distance;
+
+	if (!RayTestAABB(rays[i], object->GetCachedAABB(), Reach(i), distance))
+	{
+		return;
+	}
+
+	if (all != nullptr)
+	{
+		all[i].push_back(RayHit(object, distance));
+		return;
+	}
+
+	RayHit hit(object, distance);
+
+	if (closest[i].object == nullptr || HitLess(hit, closest[i]))
+	{
+		closest[i] = hit;
+	}
+}
+
+void RayQuery::Finish()
+{
+	if (all == nullptr)
+	{
+		return;
+	}
+
+	for (int i = 0; i < numRays; i++)
+	{
+		std::vector<RayHit>& hits = all[i];
+		std::sort(hits.begin(), hits.end(), HitLess);
+
+		// The same object always gets the same distance from the same ray, so after sorting any repeats are right next to each other.
+		hits.erase(std::unique(hits.begin(), hits.end(), [](const RayHit& a, const RayHit& b)
+		{
+			return a.object == b.object;
+		}), hits.end());
+	}
+}
+
+#endif // _RAY_QUERY_CPP
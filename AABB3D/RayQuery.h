@@ -0,0 +1,114 @@
+/*
+Title: AABB-3D
+File Name: RayQuery.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _RAY_QUERY_H
+#define _RAY_QUERY_H
+
+#include "GameObject.h"
+#include "RayCast.h"
+#include <vector>
+
+// Where a ray hit an object, or a null object if it didn't hit anything.
+struct RayHit
+{
+	GameObject* object;
+	float distance;
+
+	RayHit(GameObject* hitObject, float hitDistance)
+	{
+		object = hitObject;
+		distance = hitDistance;
+	}
+	RayHit()
+	{
+		object = nullptr;
+		distance = 0.0f;
+	}
+};
+
+// A batch of rays being cast through a broadphase, along with the hits found so far.
+// The broadphase walks its own structure to find the objects each ray might hit, and hands every one of them to Candidate, which tests the ray against the
+// object's real AABB (the broadphase only knows about grown or swept versions of it). A query either keeps only the closest hit of each ray, or every hit.
+// When only the closest hit is wanted, a ray stops looking past the closest hit it has found so far, which lets the broadphase skip everything behind it.
+// A query is only ever used by one thread, so any number of threads can cast rays at once by each using their own.
+class RayQuery
+{
+	const PreparedRay* rays;
+	int numRays;
+
+	// If closest isn't null, it holds the closest hit of every ray. Otherwise all holds a list of every hit of every ray.
+	RayHit* closest;
+	std::vector<RayHit>* all;
+
+public:
+	// A query that keeps only the closest hit of each ray in closestHits (which needs room for numRays hits).
+	RayQuery(const PreparedRay* queryRays, int count, RayHit* closestHits);
+
+	// A query that keeps every hit of each ray, in allHits (which needs room for numRays lists).
+	RayQuery(const PreparedRay* queryRays, int count, std::vector<RayHit>* allHits);
+
+	int NumRays() const
+	{
+		return numRays;
+	}
+
+	const PreparedRay& GetRay(int i) const
+	{
+		return rays[i];
+	}
+
+	// How far along ray i is still worth looking.
+	float Reach(int i) const
+	{
+		if (closest != nullptr && closest[i].object != nullptr)
+		{
+			return closest[i].distance;
+		}
+
+		return rays[i].maxDistance;
+	}
+
+	// Called by the broadphase for every object that ray i might hit. The same object can be handed over more than once.
+	void Candidate(int i, GameObject* object);
+
+	// Sorts each ray's hits by distance, and removes any object that was hit more than once. Only needed when keeping every hit.
+	void Finish();
+};
+
+#endif //_RAY_QUERY_H
@@ -0,0 +1,131 @@
+/*
+Title: AABB-3D
+File Name: Scene.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _SCENE_CPP
+#define _SCENE_CPP
+
+#include "Scene.h"
+#include <cmath>
+#include <random>
+
+Model* CreateCubeModel(float halfSize)
+{
+	float h = halfSize;
+
+	// An element array, which determines which of the vertices to display in what order. This is sometimes known as an index array.
+	unsigned int elements[] = {
+		0, 1, 2, 0, 2, 3, 3, 2, 4, 3, 4, 5, 5, 4, 6, 5, 6, 7, 7, 6, 1, 7, 1, 0, 1, 6, 4, 1, 4, 2, 7, 0, 3, 7, 3, 5
+	};
+
+	// These are the vertices for a cube.
+	VertexFormat vertices[] = {
+		VertexFormat(glm::vec3(-h, -h, h), glm::vec4(1.0, 0.0, 0.0, 1.0)),		// Front, Bottom, Left		0	red
+		VertexFormat(glm::vec3(-h, h, h), glm::vec4(1.0, 0.0, 0.0, 1.0)),		// Front, Top, Left			1	red
+		VertexFormat(glm::vec3(h, h, h), glm::vec4(1.0, 0.0, 1.0, 1.0)),		// Front, Top, Right		2	yellow
+		VertexFormat(glm::vec3(h, -h, h), glm::vec4(1.0, 0.0, 1.0, 1.0)),		// Front, Bottom, Right		3	yellow
+		VertexFormat(glm::vec3(h, h, -h), glm::vec4(0.0, 1.0, 1.0, 1.0)),		// Back, Top, Right			4	cyan
+		VertexFormat(glm::vec3(h, -h, -h), glm::vec4(0.0, 1.0, 1.0, 1.0)),		// Back, Bottom, Right		5	cyan
+		VertexFormat(glm::vec3(-h, h, -h), glm::vec4(0.0, 1.0, 0.0, 1.0)),		// Back, Top, Left			6	blue
+		VertexFormat(glm::vec3(-h, -h, -h), glm::vec4(0.0, 1.0, 0.0, 1.0)),		// Back, Bottom, Left		7	blue
+	};
+
+	return new Model(8, vertices, 36, elements);
+}
+
+Model* CreatePyramidModel(float halfSize)
+{
+	float h = halfSize;
+
+	// Four triangles for the sides and two for the base, in clockwise order (like the cube) when looked at from outside.
+	unsigned int elements[] = {
+		0, 4, 1, 1, 4, 2, 2, 4, 3, 3, 4, 0, 0, 1, 2, 0, 2, 3
+	};
+
+	VertexFormat vertices[] = {
+		VertexFormat(glm::vec3(-h, -h, h), glm::vec4(0.0, 0.0, 1.0, 1.0)),		// Front, Bottom, Left		0	blue
+		VertexFormat(glm::vec3(h, -h, h), glm::vec4(0.0, 0.0, 1.0, 1.0)),		// Front, Bottom, Right		1	blue
+		VertexFormat(glm::vec3(h, -h, -h), glm::vec4(1.0, 0.5, 0.0, 1.0)),		// Back, Bottom, Right		2	orange
+		VertexFormat(glm::vec3(-h, -h, -h), glm::vec4(1.0, 0.5, 0.0, 1.0)),		// Back, Bottom, Left		3	orange
+		VertexFormat(glm::vec3(0, h, 0), glm::vec4(1.0, 1.0, 0.0, 1.0)),		// Top						4	yellow
+	};
+
+	return new Model(5, vertices, 18, elements);
+}
+
+void SpawnCubes(PhysicsWorld& world, GameObjectPool& pool, Model* model, int count, unsigned int seed, float speed, std::vector<GameObjectHandle>& spawned)
+{
+	// Give each cube about one unit of space on every axis.
+	float halfExtent = 0.5f * cbrtf((float)count);
+
+	// Use our own generator (instead of rand()) so that the same seed always gives the same scene, no matter what else has used rand().
+	std::mt19937 random(seed);
+	std::uniform_real_distribution<float> position(-halfExtent, halfExtent);
+	std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+	for (int i = 0; i < count; i++)
+	{
+		GameObjectHandle handle = pool.Create(model);
+		GameObject* object = pool.Get(handle);
+
+		// Pick a random direction (that isn't zero) and scale it up to the given speed.
+		// The random values are drawn one at a time, since the order that function arguments are evaluated in isn't fixed.
+		glm::vec3 velocity;
+		do
+		{
+			velocity.x = direction(random);
+			velocity.y = direction(random);
+			velocity.z = direction(random);
+		} while (glm::length(velocity) < 0.001f);
+
+		float x = position(random);
+		float y = position(random);
+		float z = position(random);
+
+		object->SetPosition(glm::vec3(x, y, z));
+		object->SetVelocity(glm::normalize(velocity) * speed);
+		object->SetScale(glm::vec3(0.25f, 0.25f, 0.25f));
+
+		world.AddObject(object);
+		spawned.push_back(handle);
+	}
+
+	world.SetBounds(glm::vec3(halfExtent));
+}
+
+#endif // _SCENE_CPP
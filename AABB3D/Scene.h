@@ -0,0 +1,60 @@
+/*
+Title: AABB-3D
+File Name: Scene.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _SCENE_H
+#define _SCENE_H
+
+#include "Physics.h"
+#include "GameObjectPool.h"
+#include <vector>
+
+// Creates the colored cube model used by the demo. The cube goes from -halfSize to halfSize on every axis.
+// The caller owns the returned model.
+Model* CreateCubeModel(float halfSize = 0.25f);
+
+// Creates a colored square pyramid, with its base at -halfSize and its tip at halfSize on the y axis, and its base going from -halfSize to halfSize on
+// the other two. The caller owns the returned model.
+Model* CreatePyramidModel(float halfSize = 0.25f);
+
+// Fills a box with count cubes at random positions and with random velocities (of the given speed), and adds them to the world.
+// The box is sized so that there is roughly the same amount of room per cube no matter how many there are, and the world's bounds are set to match it.
+// The same seed always gives the same scene. The new objects are created in the given pool, and their handles are added to spawned.
+void SpawnCubes(PhysicsWorld& world, GameObjectPool& pool, Model* model, int count, unsigned int seed, float speed, std::vector<GameObjectHandle>& spawned);
+
+#endif //_SCENE_H
@@ -0,0 +1,75 @@
+/*
+Title: AABB-3D
+File Name: Simd.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _SIMD_H
+#define _SIMD_H
+
+#include <cstdlib>
+#include <cstdint>
+
+// Pick the widest set of vector instructions we were compiled for.
+// SSE2 is always there on x86-64 (and on 32-bit MSVC builds with /arch:SSE2, which is the default), so the vector path is what you get unless you're on
+// some other kind of CPU. Build with AVX enabled (-mavx on GCC/Clang, /arch:AVX on MSVC) to work on 8 floats per instruction instead of 4.
+#if defined(__AVX__)
+#define PHYSICS_AVX
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PHYSICS_SSE
+#include <emmintrin.h>
+#endif
+
+// Allocates memory for count floats whose address is a multiple of 32 bytes (which AVX loads need).
+// We over-allocate, round the address up, and hide the original pointer just before the aligned block so we can free it later.
+inline float* AlignedAlloc(int count)
+{
+	void* raw = malloc(sizeof(float) * count + 32 + sizeof(void*));
+	uintptr_t aligned = ((uintptr_t)raw + sizeof(void*) + 31) & ~(uintptr_t)31;
+	((void**)aligned)[-1] = raw;
+	return (float*)aligned;
+}
+
+inline void AlignedFree(float* ptr)
+{
+	if (ptr != nullptr)
+	{
+		free(((void**)ptr)[-1]);
+	}
+}
+
+#endif //_SIMD_H
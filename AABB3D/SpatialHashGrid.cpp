@@ -0,0 +1,522 @@
+/*
+Title: AABB-3D
+File Name: SpatialHashGrid.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _SPATIAL_HASH_GRID_CPP
+#define _SPATIAL_HASH_GRID_CPP
+
+#include "SpatialHashGrid.h"
+#include "Physics.h"
+#include <algorithm>
+#include <cmath>
+
+// Turns a coordinate into the index of the cell it's in. The value is clamped first, so that a box that has flown off to somewhere crazy can't overflow an int.
+static int CellIndex(float value, float inverseCellSize)
+{
+	float cell = floorf(value * inverseCellSize);
+	cell = std::max(-1.0e9f, std::min(1.0e9f, cell));
+	return (int)cell;
+}
+
+// Mixes the three coordinates of a cell into one number. Multiplying by large primes spreads nearby cells out across the table.
+static unsigned int HashCell(int x, int y, int z)
+{
+	return ((unsigned int)x * 73856093u) ^ ((unsigned int)y * 19349663u) ^ ((unsigned int)z * 83492791u);
+}
+
+SpatialHashGrid::SpatialHashGrid(float size)
+{
+	fixedCellSize = size;
+	cellSize = size > 0.0f ? size : 1.0f;
+	quantize = false;
+	hasGrid = false;
+}
+
+int SpatialHashGrid::CreateProxy(const AABB& box, GameObject* object)
+{
+	int proxy;
+
+	// Reuse an old proxy slot if we have one, otherwise make a new one.
+	if (!freeProxies.empty())
+	{
+		proxy = freeProxies.back();
+		freeProxies.pop_back();
+	}
+	else
+	{
+		proxy = (int)proxies.size();
+		proxies.push_back(Proxy());
+	}
+
+	proxies[proxy].box = box;
+	proxies[proxy].object = object;
+	proxies[proxy].inUse = true;
+
+	newProxies.push_back(proxy);
+
+	return proxy;
+}
+
+void SpatialHashGrid::DestroyProxy(int proxy)
+{
+	proxies[proxy].inUse = false;
+	proxies[proxy].object = nullptr;
+	freeProxies.push_back(proxy);
+}
+
+void SpatialHashGrid::MoveProxy(int proxy, const AABB& box)
+{
+	// The grid is rebuilt from scratch in FindPairs, so all we need to do here is save the box.
+	proxies[proxy].box = box;
+}
+
+// Picks a cell size from the median size of the boxes (the size of a box being its longest side).
+// With cells that big, a typical box touches at most 2 cells along each axis, and a cell can't hold many boxes unless they're piled on top of each other.
+// The median is used instead of the average so that a few huge boxes (like a floor) don't blow up the cell size for everything else.
+float SpatialHashGrid::ChooseCellSize()
+{
+	if (fixedCellSize > 0.0f)
+	{
+		return fixedCellSize;
+	}
+
+	sizes.clear();
+
+	for (size_t i = 0; i < proxies.size(); i++)
+	{
+		if (proxies[i].inUse)
+		{
+			glm::vec3 size = proxies[i].box.max - proxies[i].box.min;
+			sizes.push_back(std::max(size.x, std::max(size.y, size.z)));
+		}
+	}
+
+	if (sizes.empty())
+	{
+		return cellSize;
+	}
+
+	std::nth_element(sizes.begin(), sizes.begin() + sizes.size() / 2, sizes.end());
+	float median = sizes[sizes.size() / 2];
+
+	// Points (or very flat boxes) would give a cell size of zero, so keep the old size in that case.
+	return median > 0.0f ? median : cellSize;
+}
+
+// Sets the quantizer's region to just cover every box, and quantizes them all.
+void SpatialHashGrid::QuantizeBoxes()
+{
+	AABB region;
+	bool first = true;
+
+	for (size_t i = 0; i < proxies.size(); i++)
+	{
+		if (!proxies[i].inUse)
+		{
+			continue;
+		}
+
+		if (first)
+		{
+			region = proxies[i].box;
+			first = false;
+		}
+		else
+		{
+			region.min = glm::min(region.min, proxies[i].box.min);
+			region.max = glm::max(region.max, proxies[i].box.max);
+		}
+	}
+
+	quantizer.SetRegion(region);
+	quantizedBoxes.resize(proxies.size());
+
+	for (size_t i = 0; i < proxies.size(); i++)
+	{
+		if (proxies[i].inUse)
+		{
+			quantizedBoxes[i] = quantizer.Quantize(proxies[i].box);
+		}
+	}
+}
+
+void SpatialHashGrid::FindPairs(std::vector<BroadphasePair>& pairs, JobSystem* jobs)
+{
+	pairs.clear();
+
+	if (quantize)
+	{
+		QuantizeBoxes();
+	}
+
+	cellSize = ChooseCellSize();
+	float inverseCellSize = 1.0f / cellSize;
+
+	// Work out which cells each box touches.
+	entries.clear();
+	oversized.clear();
+	oversizedIndex.assign(proxies.size(), -1);
+	newProxies.clear();
+	hasGrid = false;
+
+	for (size_t i = 0; i < proxies.size(); i++)
+	{
+		if (!proxies[i].inUse)
+		{
+			continue;
+		}
+
+		const AABB& box = proxies[i].box;
+
+		int minX = CellIndex(box.min.x, inverseCellSize), maxX = CellIndex(box.max.x, inverseCellSize);
+		int minY = CellIndex(box.min.y, inverseCellSize), maxY = CellIndex(box.max.y, inverseCellSize);
+		int minZ = CellIndex(box.min.z, inverseCellSize), maxZ = CellIndex(box.max.z, inverseCellSize);
+
+		// Use doubles, since a huge box could touch more cells than fit in an int.
+		double numCells = (double)(maxX - minX + 1) * (double)(maxY - minY + 1) * (double)(maxZ - minZ + 1);
+
+		if (numCells > MAX_CELLS_PER_BOX)
+		{
+			oversizedIndex[i] = (int)oversized.size();
+			oversized.push_back((int)i);
+			continue;
+		}
+
+		if (hasGrid)
+		{
+			gridBounds.min = glm::min(gridBounds.min, box.min);
+			gridBounds.max = glm::max(gridBounds.max, box.max);
+		}
+		else
+		{
+			gridBounds = box;
+			hasGrid = true;
+		}
+
+		for (int z = minZ; z <= maxZ; z++)
+		{
+			for (int y = minY; y <= maxY; y++)
+			{
+				for (int x = minX; x <= maxX; x++)
+				{
+					Entry entry = { x, y, z, (int)i };
+					entries.push_back(entry);
+				}
+			}
+		}
+	}
+
+	// Group the entries by hash bucket with a counting sort. This is O(n), where a regular sort would be O(n log n).
+	// The table has at least twice as many buckets as entries (and a power of two, so we can use & instead of %), which keeps collisions rare.
+	unsigned int numBuckets = 1;
+	while (numBuckets < entries.size() * 2)
+	{
+		numBuckets *= 2;
+	}
+	unsigned int bucketMask = numBuckets - 1;
+
+	bucketStart.assign(numBuckets + 1, 0);
+	entryBuckets.resize(entries.size());
+
+	// Count how many entries land in each bucket.
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		entryBuckets[i] = HashCell(entries[i].x, entries[i].y, entries[i].z) & bucketMask;
+		bucketStart[entryBuckets[i]]++;
+	}
+
+	// Add the counts up, so that each bucket holds where it ends.
+	for (unsigned int b = 1; b < numBuckets; b++)
+	{
+		bucketStart[b] += bucketStart[b - 1];
+	}
+
+	// Now fill each bucket in from its end, counting its position back down as we go. Once we're done, every bucket holds where it starts. (We walk the entries
+	// backwards so that each bucket ends up in the same order as the entries were added in.)
+	sortedEntries.resize(entries.size());
+
+	for (size_t i = entries.size(); i > 0; i--)
+	{
+		int position = --bucketStart[entryBuckets[i - 1]];
+		sortedEntries[position] = entries[i - 1];
+	}
+
+	// The end of the last bucket.
+	bucketStart[numBuckets] = (int)entries.size();
+
+	// Now test every box against the other boxes in the same cell. Then test the oversized boxes against every other box. Each pair with an oversized box is
+	// only found there, since the oversized box isn't in the grid.
+	// Both of these only read the grid, so they can be split up between threads, each writing into its own list.
+	int numOversized = (int)oversized.size();
+
+	if (jobs == nullptr)
+	{
+		FindBucketPairs(0, numBuckets, inverseCellSize, pairs);
+		FindOversizedPairs(0, numOversized, pairs);
+		SortPairs(pairs);
+		return;
+	}
+
+	const int bucketsPerJob = 4096;
+	const int oversizedPerJob = 4;
+	int numBucketChunks = (int)((numBuckets + bucketsPerJob - 1) / bucketsPerJob);
+	int numChunks = numBucketChunks + (numOversized + oversizedPerJob - 1) / oversizedPerJob;
+
+	if (chunkPairs.size() < (size_t)numChunks)
+	{
+		chunkPairs.resize(numChunks);
+	}
+
+	// ParallelFor can hand the body more than one chunk at once (it runs everything in a single call when there's only one thread), so we walk through the
+	// chunks in the range ourselves. That way every chunk's list is cleared and filled this step, and none are left over from an earlier one.
+	jobs->ParallelFor((int)numBuckets, bucketsPerJob, [this, bucketsPerJob, inverseCellSize](int begin, int end)
+	{
+		for (int chunkBegin = begin; chunkBegin < end; chunkBegin += bucketsPerJob)
+		{
+			std::vector<BroadphasePair>& chunk = chunkPairs[chunkBegin / bucketsPerJob];
+			chunk.clear();
+			FindBucketPairs(chunkBegin, std::min(chunkBegin + bucketsPerJob, end), inverseCellSize, chunk);
+		}
+	});
+
+	jobs->ParallelFor(numOversized, oversizedPerJob, [this, numBucketChunks, oversizedPerJob](int begin, int end)
+	{
+		for (int chunkBegin = begin; chunkBegin < end; chunkBegin += oversizedPerJob)
+		{
+			std::vector<BroadphasePair>& chunk = chunkPairs[numBucketChunks + chunkBegin / oversizedPerJob];
+			chunk.clear();
+			FindOversizedPairs(chunkBegin, std::min(chunkBegin + oversizedPerJob, end), chunk);
+		}
+	});
+
+	MergePairs(chunkPairs, numChunks, pairs);
+}
+
+void SpatialHashGrid::FindBucketPairs(unsigned int begin, unsigned int end, float inverseCellSize, std::vector<BroadphasePair>& pairs) const
+{
+	for (unsigned int b = begin; b < end; b++)
+	{
+		int start = bucketStart[b];
+		int stop = bucketStart[b + 1];
+
+		for (int i = start; i < stop; i++)
+		{
+			const Entry& a = sortedEntries[i];
+
+			for (int j = i + 1; j < stop; j++)
+			{
+				const Entry& c = sortedEntries[j];
+
+				// Different cells can hash to the same bucket, and those aren't really neighbors.
+				if (a.x != c.x || a.y != c.y || a.z != c.z)
+				{
+					continue;
+				}
+
+				// If the quantized boxes don't overlap, the real ones can't either.
+				if (quantize && !TestQuantizedAABB(quantizedBoxes[a.proxy], quantizedBoxes[c.proxy]))
+				{
+					continue;
+				}
+
+				const AABB& boxA = proxies[a.proxy].box;
+				const AABB& boxB = proxies[c.proxy].box;
+
+				if (!TestAABB(boxA, boxB))
+				{
+					continue;
+				}
+
+				// Two boxes that overlap across a few cells will meet in every one of those cells. To report them only once, we only report them in the cell
+				// that holds the min corner of the area where they overlap. That's exactly one cell, so no pair is reported twice, and no list of already
+				// reported pairs is needed.
+				glm::vec3 overlapMin = glm::max(boxA.min, boxB.min);
+
+				if (CellIndex(overlapMin.x, inverseCellSize) != a.x ||
+					CellIndex(overlapMin.y, inverseCellSize) != a.y ||
+					CellIndex(overlapMin.z, inverseCellSize) != a.z)
+				{
+					continue;
+				}
+
+				int proxyA = std::min(a.proxy, c.proxy);
+				int proxyB = std::max(a.proxy, c.proxy);
+				pairs.push_back(BroadphasePair(proxyA, proxyB, proxies[proxyA].object, proxies[proxyB].object));
+			}
+		}
+	}
+}
+
+// When both boxes are oversized, only the first one in the oversized list reports the pair.
+void SpatialHashGrid::FindOversizedPairs(int begin, int end, std::vector<BroadphasePair>& pairs) const
+{
+	for (int i = begin; i < end; i++)
+	{
+		int big = oversized[i];
+		const AABB& bigBox = proxies[big].box;
+
+		for (size_t other = 0; other < proxies.size(); other++)
+		{
+			int o = (int)other;
+
+			// This loop runs over every proxy, so it's where the smaller quantized boxes help the most.
+			if (quantize && !TestQuantizedAABB(quantizedBoxes[big], quantizedBoxes[o]))
+			{
+				continue;
+			}
+
+			if (o == big || !proxies[o].inUse || !TestAABB(bigBox, proxies[o].box))
+			{
+				continue;
+			}
+
+			// If the other box is oversized too, skip it unless it comes after this one in the oversized list.
+			if (oversizedIndex[o] != -1 && oversizedIndex[o] <= i)
+			{
+				continue;
+			}
+
+			int proxyA = std::min(big, o);
+			int proxyB = std::max(big, o);
+			pairs.push_back(BroadphasePair(proxyA, proxyB, proxies[proxyA].object, proxies[proxyB].object));
+		}
+	}
+}
+
+void SpatialHashGrid::CastRays(RayQuery& query) const
+{
+	unsigned int numBuckets = bucketStart.empty() ? 0 : (unsigned int)bucketStart.size() - 1;
+	unsigned int bucketMask = numBuckets - 1;
+	float inverseCellSize = 1.0f / cellSize;
+
+	// The cells that the grid covers. Nothing outside of these has anything in it.
+	int lowCell[3], highCell[3];
+	for (int axis = 0; axis < 3; axis++)
+	{
+		lowCell[axis] = CellIndex(gridBounds.min[axis], inverseCellSize);
+		highCell[axis] = CellIndex(gridBounds.max[axis], inverseCellSize);
+	}
+
+	for (int r = 0; r < query.NumRays(); r++)
+	{
+		const PreparedRay& ray = query.GetRay(r);
+
+		// The boxes that aren't in the grid get tested one at a time.
+		for (size_t i = 0; i < oversized.size(); i++)
+		{
+			if (proxies[oversized[i]].inUse)
+			{
+				query.Candidate(r, proxies[oversized[i]].object);
+			}
+		}
+		for (size_t i = 0; i < newProxies.size(); i++)
+		{
+			if (proxies[newProxies[i]].inUse)
+			{
+				query.Candidate(r, proxies[newProxies[i]].object);
+			}
+		}
+
+		float enter, exit;
+		if (!hasGrid || numBuckets == 0 || !RayTestAABB(ray, gridBounds, query.Reach(r), enter, exit))
+		{
+			continue;
+		}
+
+		// Walk through the cells the ray passes through, in order, starting from the cell where it enters the grid. This is the voxel traversal of
+		// Amanatides and Woo: on every axis we keep track of how far along the ray it crosses into the next cell (next), and how far it has to go to
+		// cross a whole cell (delta). Each step moves into the next cell along whichever axis gets crossed first.
+		int cell[3], step[3];
+		float next[3], delta[3];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			float inverse = ray.inverseDirection[axis];
+			float entryPoint = ray.origin[axis] + enter / inverse;
+
+			cell[axis] = std::max(lowCell[axis], std::min(highCell[axis], CellIndex(entryPoint, inverseCellSize)));
+			step[axis] = inverse >= 0.0f ? 1 : -1;
+
+			float boundary = (float)(cell[axis] + (step[axis] > 0 ? 1 : 0)) * cellSize;
+			next[axis] = (boundary - ray.origin[axis]) * inverse;
+			delta[axis] = cellSize * fabsf(inverse);
+		}
+
+		while (true)
+		{
+			// Hand over every box in this cell. (Other cells can share the bucket, so check the coordinates.)
+			unsigned int b = HashCell(cell[0], cell[1], cell[2]) & bucketMask;
+
+			for (int i = bucketStart[b]; i < bucketStart[b + 1]; i++)
+			{
+				const Entry& entry = sortedEntries[i];
+
+				if (entry.x == cell[0] && entry.y == cell[1] && entry.z == cell[2] && proxies[entry.proxy].inUse)
+				{
+					query.Candidate(r, proxies[entry.proxy].object);
+				}
+			}
+
+			int axis = 0;
+			if (next[1] < next[axis])
+			{
+				axis = 1;
+			}
+			if (next[2] < next[axis])
+			{
+				axis = 2;
+			}
+
+			// Stop once the ray leaves the grid, or gets past its reach (which shrinks as closer hits are found).
+			if (next[axis] > std::min(exit, query.Reach(r)))
+			{
+				break;
+			}
+
+			cell[axis] += step[axis];
+			if (cell[axis] < lowCell[axis] || cell[axis] > highCell[axis])
+			{
+				break;
+			}
+
+			next[axis] += delta[axis];
+		}
+	}
+}
+
+#endif // _SPATIAL_HASH_GRID_CPP
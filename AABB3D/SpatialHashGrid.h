@@ -0,0 +1,157 @@
+/*
+Title: AABB-3D
+File Name: SpatialHashGrid.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _SPATIAL_HASH_GRID_H
+#define _SPATIAL_HASH_GRID_H
+
+#include "Broadphase.h"
+#include "QuantizedAABB.h"
+
+// Uniform grid broadphase.
+// Space is cut up into cubes ("cells") that are all the same size, and every box is dropped into each cell that it touches. Two boxes can only overlap if
+// they share a cell, so we only have to test boxes against the other boxes in their own cells. If the cells are about the same size as the boxes, each box
+// only touches a few cells and each cell only holds a few boxes, so finding every pair is close to O(n).
+// That makes this a great fit for scenes full of objects that are all about the same size (like the demo, with lots of cubes from one model). It's a poor
+// fit when sizes vary wildly, which is what the tree and sweep-and-prune broadphases are better at.
+// The grid is infinite: instead of keeping an array of every cell, the cells that have something in them are found through a hash of their coordinates.
+class SpatialHashGrid : public Broadphase
+{
+	struct Proxy
+	{
+		AABB box;
+		GameObject* object;
+		bool inUse;
+	};
+
+	// One box in one cell.
+	struct Entry
+	{
+		int x, y, z;
+		int proxy;
+	};
+
+	std::vector<Proxy> proxies;
+	std::vector<int> freeProxies;
+
+	// If this is 0, the cell size is worked out every step from the sizes of the boxes. Otherwise it's used as the cell size.
+	float fixedCellSize;
+
+	// The cell size used by the last FindPairs.
+	float cellSize;
+
+	// Every box's cells, and which hash bucket each of those went into.
+	std::vector<Entry> entries;
+	std::vector<unsigned int> entryBuckets;
+
+	// The entries sorted by bucket. The entries of bucket b are sortedEntries[bucketStart[b]] to sortedEntries[bucketStart[b + 1] - 1].
+	std::vector<Entry> sortedEntries;
+	std::vector<int> bucketStart;
+
+	// Boxes that would touch too many cells (because they're much bigger than the cell size) are kept out of the grid and tested against every box instead.
+	std::vector<int> oversized;
+
+	// Where each proxy is in the oversized list (by proxy ID), or -1 if it isn't oversized.
+	std::vector<int> oversizedIndex;
+
+	// A box around every box in the grid (not counting the oversized ones), as of the last FindPairs. Rays are clipped to this before walking through the
+	// cells. hasGrid is false until a FindPairs puts something in the grid.
+	AABB gridBounds;
+	bool hasGrid;
+
+	// Proxies created since the last FindPairs. They aren't in the grid yet, so rays test them one at a time.
+	std::vector<int> newProxies;
+
+	std::vector<float> sizes;
+
+	// If quantize is true, every box is also stored as a QuantizedAABB (by proxy ID), over a region that covers every box. The pair tests check those
+	// first, and only look at the real boxes for pairs that pass. A quantized box is 12 bytes, where a Proxy is 40, so the tests pull in far less memory.
+	bool quantize;
+	AABBQuantizer quantizer;
+	std::vector<QuantizedAABB> quantizedBoxes;
+
+	void QuantizeBoxes();
+
+	// One list of pairs per chunk, when FindPairs is split across threads.
+	std::vector<std::vector<BroadphasePair> > chunkPairs;
+
+	float ChooseCellSize();
+
+	// Finds the pairs that meet in the hash buckets from begin up to end.
+	void FindBucketPairs(unsigned int begin, unsigned int end, float inverseCellSize, std::vector<BroadphasePair>& pairs) const;
+
+	// Finds the pairs for the oversized boxes from begin up to end in the oversized list.
+	void FindOversizedPairs(int begin, int end, std::vector<BroadphasePair>& pairs) const;
+
+public:
+	// If a box would touch more than this many cells, it goes in the oversized list instead.
+	static const int MAX_CELLS_PER_BOX = 64;
+
+	// cellSize is the width of a cell. Leave it at 0 to have it picked automatically, which is usually what you want.
+	SpatialHashGrid(float cellSize = 0.0f);
+
+	int CreateProxy(const AABB& box, GameObject* object);
+	void DestroyProxy(int proxy);
+	void MoveProxy(int proxy, const AABB& box);
+	void FindPairs(std::vector<BroadphasePair>& pairs, JobSystem* jobs = nullptr);
+
+	// Walks each ray through the grid one cell at a time (in the order it passes through them), only looking at the boxes in those cells.
+	void CastRays(RayQuery& query) const;
+
+	// Sets the width of a cell, or 0 to have it picked automatically.
+	void SetCellSize(float size)
+	{
+		fixedCellSize = size;
+	}
+	float GetCellSize()
+	{
+		return cellSize;
+	}
+
+	// Turns the quantized pre-test on or off. The pairs found are exactly the same either way.
+	void SetQuantized(bool enabled)
+	{
+		quantize = enabled;
+	}
+	bool GetQuantized()
+	{
+		return quantize;
+	}
+};
+
+#endif //_SPATIAL_HASH_GRID_H
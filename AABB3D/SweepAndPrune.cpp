@@ -0,0 +1,450 @@
+/*
+Title: AABB-3D
+File Name: SweepAndPrune.cpp
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _SWEEP_AND_PRUNE_CPP
+#define _SWEEP_AND_PRUNE_CPP
+
+#include "SweepAndPrune.h"
+#include "Physics.h"
+#include <algorithm>
+#include <cfloat>
+
+// Returns true if endpoint a belongs before endpoint b in a sorted list.
+// When two endpoints have the same value, the min goes first so that boxes that are just touching still count as overlapping (just like TestAABB).
+static bool EndpointLess(float aValue, bool aIsMin, float bValue, bool bIsMin)
+{
+	return aValue < bValue || (aValue == bValue && aIsMin && !bIsMin);
+}
+
+SweepAndPrune::SweepAndPrune()
+{
+	sweepAxis = 0;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		sortedCount[axis] = 0;
+	}
+}
+
+SweepAndPrune::~SweepAndPrune()
+{
+	for (size_t i = 0; i < chunkStates.size(); i++)
+	{
+		delete chunkStates[i];
+	}
+}
+
+int SweepAndPrune::CreateProxy(const AABB& box, GameObject* object)
+{
+	int proxy;
+
+	// Reuse an old proxy slot if we have one, otherwise make a new one.
+	if (!freeProxies.empty())
+	{
+		proxy = freeProxies.back();
+		freeProxies.pop_back();
+	}
+	else
+	{
+		proxy = (int)proxies.size();
+		proxies.push_back(Proxy());
+	}
+
+	proxies[proxy].box = box;
+	proxies[proxy].object = object;
+	proxies[proxy].inUse = true;
+
+	if (proxy == proxyBoxes.Size())
+	{
+		proxyBoxes.Add(box);
+	}
+	else
+	{
+		proxyBoxes.Set(proxy, box);
+	}
+
+	// Add the min and max of the box to the end of each axis list. They will be moved into place the next time the lists are sorted.
+	for (int axis = 0; axis < 3; axis++)
+	{
+		Endpoint minPoint = { box.min[axis], proxy, true };
+		Endpoint maxPoint = { box.max[axis], proxy, false };
+
+		endpoints[axis].push_back(minPoint);
+		endpoints[axis].push_back(maxPoint);
+	}
+
+	return proxy;
+}
+
+void SweepAndPrune::DestroyProxy(int proxy)
+{
+	// Searching every list for this proxy's endpoints would make removing an object O(n). Instead we just mark the proxy as dead, and its endpoints get
+	// dropped in the pass over the lists that FindPairs makes anyway. Its ID can't be handed out again until then, or the old endpoints would belong to the
+	// new proxy.
+	proxies[proxy].inUse = false;
+	proxies[proxy].object = nullptr;
+	deadProxies.push_back(proxy);
+
+	proxyBoxes.Set(proxy, AABB(glm::vec3(FLT_MAX), glm::vec3(-FLT_MAX)));
+}
+
+void SweepAndPrune::MoveProxy(int proxy, const AABB& box)
+{
+	// We just save the box here. The endpoints get updated all at once in FindPairs, which is much friendlier to the cache than jumping around the lists here.
+	proxies[proxy].box = box;
+	proxyBoxes.Set(proxy, box);
+}
+
+// Copies the current box values of each proxy into the endpoints of the given axis, and drops the endpoints of dead proxies.
+// Dropping endpoints doesn't change the order of the rest, so the list stays (almost) sorted.
+void SweepAndPrune::RefreshEndpoints(int axis)
+{
+	std::vector<Endpoint>& list = endpoints[axis];
+	size_t kept = 0;
+	size_t sorted = sortedCount[axis];
+
+	for (size_t i = 0; i < list.size(); i++)
+	{
+		const Proxy& owner = proxies[list[i].proxy];
+
+		if (!owner.inUse)
+		{
+			// Dropping a sorted endpoint leaves one fewer of them at the front of the list.
+			if (i < sortedCount[axis])
+			{
+				sorted--;
+			}
+			continue;
+		}
+
+		list[kept] = list[i];
+		list[kept].value = list[kept].isMin ? owner.box.min[axis] : owner.box.max[axis];
+		kept++;
+	}
+
+	list.resize(kept);
+	sortedCount[axis] = sorted;
+}
+
+// Sorts the first count endpoints of the given axis with insertion sort.
+// Since the list was sorted last step and things have only moved a little bit since then, each endpoint only needs to move a few places (if at all).
+void SweepAndPrune::InsertionSort(int axis, size_t count)
+{
+	std::vector<Endpoint>& list = endpoints[axis];
+
+	for (size_t i = 1; i < count; i++)
+	{
+		Endpoint key = list[i];
+		size_t j = i;
+
+		while (j > 0 && EndpointLess(key.value, key.isMin, list[j - 1].value, list[j - 1].isMin))
+		{
+			list[j] = list[j - 1];
+			j--;
+		}
+
+		list[j] = key;
+	}
+}
+
+void SweepAndPrune::SortEndpoints(int axis)
+{
+	std::vector<Endpoint>& list = endpoints[axis];
+	size_t sorted = sortedCount[axis];
+
+	auto order = [](const Endpoint& a, const Endpoint& b)
+	{
+		return EndpointLess(a.value, a.isMin, b.value, b.isMin);
+	};
+
+	// New endpoints are added to the end of the list, so insertion sort would have to carry each one all the way across it. That makes the first step (and
+	// any step right after spawning lots of objects) O(n^2). Instead, the new endpoints are sorted on their own and merged in, which is O(n log n).
+	// If most of the list is new (like on the first step), it's quicker to just sort the whole thing.
+	if (list.size() - sorted > sorted)
+	{
+		std::sort(list.begin(), list.end(), order);
+	}
+	else
+	{
+		InsertionSort(axis, sorted);
+
+		if (sorted < list.size())
+		{
+			std::sort(list.begin() + sorted, list.end(), order);
+			std::inplace_merge(list.begin(), list.begin() + sorted, list.end(), order);
+		}
+	}
+
+	sortedCount[axis] = list.size();
+}
+
+void SweepAndPrune::FindPairs(std::vector<BroadphasePair>& pairs, JobSystem* jobs)
+{
+	pairs.clear();
+
+	// Work out how spread out the box centers are on each axis (the variance), so that we can sweep along the best one.
+	glm::vec3 sum(0.0f);
+	glm::vec3 sumSquared(0.0f);
+	int count = 0;
+
+	for (size_t i = 0; i < proxies.size(); i++)
+	{
+		if (!proxies[i].inUse)
+		{
+			continue;
+		}
+
+		glm::vec3 center = (proxies[i].box.min + proxies[i].box.max) * 0.5f;
+		sum += center;
+		sumSquared += center * center;
+		count++;
+	}
+
+	// Keep all three lists sorted, even though we only sweep one of them. That way, when the best axis changes, the list we switch to is still almost sorted.
+	for (int axis = 0; axis < 3; axis++)
+	{
+		RefreshEndpoints(axis);
+		SortEndpoints(axis);
+	}
+
+	// The dead proxies' endpoints are gone now, so their IDs can be used again.
+	freeProxies.insert(freeProxies.end(), deadProxies.begin(), deadProxies.end());
+	deadProxies.clear();
+
+	if (count < 2)
+	{
+		return;
+	}
+
+	glm::vec3 variance = sumSquared - sum * sum / (float)count;
+
+	sweepAxis = 0;
+	if (variance.y > variance[sweepAxis])
+	{
+		sweepAxis = 1;
+	}
+	if (variance.z > variance[sweepAxis])
+	{
+		sweepAxis = 2;
+	}
+
+	int numEndpoints = (int)endpoints[sweepAxis].size();
+
+	// With only one thread, there's nothing to gain from splitting up the sweep.
+	if (jobs == nullptr || jobs->NumThreads() < 2)
+	{
+		Sweep(sweep, 0, numEndpoints, nullptr, 0, pairs);
+		SortPairs(pairs);
+		return;
+	}
+
+	// The sweep walks the list in order and keeps track of the active boxes as it goes, so we split the list into chunks and sweep each one on its own.
+	// A pair is always found at the min endpoint of whichever box starts later, by testing it against the boxes that are active there. Those are the boxes
+	// that started earlier in the same chunk, plus the ones that started in an earlier chunk and haven't ended yet. So each chunk starts its sweep with those
+	// boxes already active (its "seeds"), and then finds exactly the pairs whose later min endpoint is in the chunk.
+	// Every chunk needs its own per-proxy lookup table, so we only make a few chunks per thread rather than lots of small ones. The pairs get sorted at the
+	// end, so the result is the same no matter how many chunks there are.
+	const int minEndpointsPerChunk = 2048;
+	int numChunks = std::min(jobs->NumThreads() * 4, (numEndpoints + minEndpointsPerChunk - 1) / minEndpointsPerChunk);
+	int endpointsPerChunk = (numEndpoints + numChunks - 1) / numChunks;
+	numChunks = (numEndpoints + endpointsPerChunk - 1) / endpointsPerChunk;
+
+	// Find the seeds with one pass over the list. This only adds and removes proxies from the active list, without testing any boxes, so it's quick.
+	const std::vector<Endpoint>& list = endpoints[sweepAxis];
+	chunkSeeds.clear();
+	chunkSeedStart.clear();
+	sweep.activeIndex.resize(proxies.size(), -1);
+
+	for (int i = 0; i < numEndpoints; i++)
+	{
+		if (i % endpointsPerChunk == 0)
+		{
+			chunkSeedStart.push_back((int)chunkSeeds.size());
+			chunkSeeds.insert(chunkSeeds.end(), sweep.active.begin(), sweep.active.end());
+		}
+
+		if (list[i].isMin)
+		{
+			sweep.Add(list[i].proxy, proxies[list[i].proxy].box);
+		}
+		else
+		{
+			sweep.Remove(list[i].proxy);
+		}
+	}
+	chunkSeedStart.push_back((int)chunkSeeds.size());
+
+	while (chunkStates.size() < (size_t)numChunks)
+	{
+		chunkStates.push_back(new SweepState());
+	}
+	if (chunkPairs.size() < (size_t)numChunks)
+	{
+		chunkPairs.resize(numChunks);
+	}
+
+	// ParallelFor can hand the body more than one chunk at once (it runs everything in a single call when there's only one thread), so we walk through the
+	// chunks in the range ourselves. Every chunk's list gets filled in this step, so none of them are left over from an earlier one.
+	jobs->ParallelFor(numChunks, 1, [this, endpointsPerChunk, numEndpoints](int begin, int end)
+	{
+		for (int chunk = begin; chunk < end; chunk++)
+		{
+			int first = chunk * endpointsPerChunk;
+			const int* seeds = chunkSeeds.data() + chunkSeedStart[chunk];
+			int numSeeds = chunkSeedStart[chunk + 1] - chunkSeedStart[chunk];
+
+			chunkPairs[chunk].clear();
+			Sweep(*chunkStates[chunk], first, std::min(first + endpointsPerChunk, numEndpoints), seeds, numSeeds, chunkPairs[chunk]);
+		}
+	});
+
+	MergePairs(chunkPairs, numChunks, pairs);
+}
+
+void SweepAndPrune::SweepState::Add(int proxy, const AABB& box)
+{
+	activeIndex[proxy] = (int)active.size();
+	active.push_back(proxy);
+	activeBoxes.Add(box);
+}
+
+void SweepAndPrune::SweepState::Remove(int proxy)
+{
+	int index = activeIndex[proxy];
+	int last = active.back();
+
+	active[index] = last;
+	activeIndex[last] = index;
+	active.pop_back();
+	activeBoxes.RemoveSwap(index);
+	activeIndex[proxy] = -1;
+}
+
+void SweepAndPrune::SweepState::Clear()
+{
+	for (size_t i = 0; i < active.size(); i++)
+	{
+		activeIndex[active[i]] = -1;
+	}
+
+	active.clear();
+	activeBoxes.Clear();
+}
+
+void SweepAndPrune::Sweep(SweepState& state, int begin, int end, const int* seeds, int numSeeds, std::vector<BroadphasePair>& pairs)
+{
+	const std::vector<Endpoint>& list = endpoints[sweepAxis];
+
+	// New proxies may have been created since the last sweep.
+	state.activeIndex.resize(proxies.size(), -1);
+
+	for (int i = 0; i < numSeeds; i++)
+	{
+		state.Add(seeds[i], proxies[seeds[i]].box);
+	}
+
+	// Sweep through the sorted list. When we hit the min of a box, that box overlaps (on this axis) every box that is currently active.
+	// When we hit the max of a box, it can't overlap anything else further along, so it stops being active.
+	for (int i = begin; i < end; i++)
+	{
+		int proxy = list[i].proxy;
+		const AABB& box = proxies[proxy].box;
+
+		if (list[i].isMin)
+		{
+			// Test the new box against every active box at once. They already overlap on the sweep axis, so this is really checking the other two.
+			state.hitMasks.resize((state.active.size() + 31) / 32);
+			state.activeBoxes.OverlapMasks(box, state.hitMasks.data());
+
+			for (size_t w = 0; w < state.hitMasks.size(); w++)
+			{
+				unsigned int mask = state.hitMasks[w];
+
+				for (int bit = 0; mask != 0; bit++, mask >>= 1)
+				{
+					if (!(mask & 1))
+					{
+						continue;
+					}
+
+					int other = state.active[w * 32 + bit];
+					int a = std::min(proxy, other);
+					int b = std::max(proxy, other);
+					pairs.push_back(BroadphasePair(a, b, proxies[a].object, proxies[b].object));
+				}
+			}
+
+			state.Add(proxy, box);
+		}
+		else
+		{
+			state.Remove(proxy);
+		}
+	}
+
+	// Boxes that are still active at the end of a chunk carry on into the next one (where they're seeds), so they need clearing out here.
+	state.Clear();
+}
+
+void SweepAndPrune::CastRays(RayQuery& query) const
+{
+	int numBlocks = (proxyBoxes.Size() + 7) / 8;
+	float distances[8];
+
+	for (int r = 0; r < query.NumRays(); r++)
+	{
+		const PreparedRay& ray = query.GetRay(r);
+
+		for (int block = 0; block < numBlocks; block++)
+		{
+			// The reach is read again for every block, since it shrinks as closer hits are found.
+			unsigned int mask = proxyBoxes.RayMask8(ray, query.Reach(r), block, distances);
+
+			for (int k = 0; mask != 0; k++, mask >>= 1)
+			{
+				if (mask & 1)
+				{
+					query.Candidate(r, proxies[block * 8 + k].object);
+				}
+			}
+		}
+	}
+}
+
+#endif // _SWEEP_AND_PRUNE_CPP
@@ -0,0 +1,148 @@
+/*
+Title: AABB-3D
+File Name: SweepAndPrune.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _SWEEP_AND_PRUNE_H
+#define _SWEEP_AND_PRUNE_H
+
+#include "Broadphase.h"
+#include "AABBStore.h"
+
+// Sort-and-sweep (also called sweep-and-prune) broadphase.
+// Every box is projected onto the X, Y, and Z axes as a pair of endpoints (its min and its max). We keep one sorted list of endpoints per axis, and walking
+// through a sorted list from start to end tells us exactly which boxes overlap on that axis.
+// Objects only move a little bit every physics step, so the lists are almost sorted already at the start of each step. Insertion sort is O(n) on an almost
+// sorted list, which is why we re-sort the old lists instead of building new ones every step. (This is called exploiting frame-to-frame coherence.)
+class SweepAndPrune : public Broadphase
+{
+	// A single min or max value of a box on one axis.
+	struct Endpoint
+	{
+		float value;
+		int proxy;
+		bool isMin;
+	};
+
+	struct Proxy
+	{
+		AABB box;
+		GameObject* object;
+		bool inUse;
+	};
+
+	// Everything a sweep keeps track of as it walks along the list.
+	struct SweepState
+	{
+		// The proxies whose min endpoint we've passed but whose max endpoint we haven't.
+		std::vector<int> active;
+
+		// Where each proxy is in the active list (by proxy ID), or -1 if it isn't in there. This is all -1 again once the sweep is done.
+		std::vector<int> activeIndex;
+
+		// The boxes of the active proxies (in the same order as the active list), stored so that we can test a new box against 8 of them at a time.
+		AABBStore activeBoxes;
+		std::vector<unsigned int> hitMasks;
+
+		void Add(int proxy, const AABB& box);
+
+		// Removes a proxy by moving the last active proxy into its place.
+		void Remove(int proxy);
+
+		// Empties the active list.
+		void Clear();
+	};
+
+	std::vector<Endpoint> endpoints[3];
+
+	// How many endpoints at the start of each list were sorted by the last FindPairs. New endpoints are added to the end, after these.
+	size_t sortedCount[3];
+	std::vector<Proxy> proxies;
+	std::vector<int> freeProxies;
+
+	// Proxies that have been destroyed, but whose endpoints are still in the lists. They're dropped from the lists (and their IDs can be used again) the
+	// next time FindPairs refreshes the endpoints.
+	std::vector<int> deadProxies;
+
+	// The state of the sweep when FindPairs runs on one thread.
+	SweepState sweep;
+
+	// The axis we sweep along. This is picked every step as the axis along which the boxes are the most spread out, since that gives the fewest false positives.
+	int sweepAxis;
+
+	// When FindPairs is split across threads, every chunk of the list is swept with its own state, and writes its own list of pairs.
+	// The states are kept by pointer, since the AABBStore in each one can't be copied.
+	std::vector<SweepState*> chunkStates;
+	std::vector<std::vector<BroadphasePair> > chunkPairs;
+
+	// The proxies that are still active at the start of each chunk. Chunk c's are chunkSeeds[chunkSeedStart[c]] to chunkSeeds[chunkSeedStart[c + 1] - 1].
+	std::vector<int> chunkSeeds;
+	std::vector<int> chunkSeedStart;
+
+	// Every proxy's box, by proxy ID, for ray casts. Free proxies are given an empty box, which no ray can hit.
+	AABBStore proxyBoxes;
+
+	void RefreshEndpoints(int axis);
+	void InsertionSort(int axis, size_t count);
+
+	// Sorts the endpoints of the given axis, using insertion sort on the ones that were already sorted and a full sort on the new ones.
+	void SortEndpoints(int axis);
+
+	// Sweeps the endpoints from begin up to end of the sweep axis list, and adds the pairs it finds to pairs. The seeds are the proxies that are already
+	// active at begin (they started before it, and end at or after it).
+	void Sweep(SweepState& state, int begin, int end, const int* seeds, int numSeeds, std::vector<BroadphasePair>& pairs);
+
+public:
+	SweepAndPrune();
+	~SweepAndPrune();
+
+	int CreateProxy(const AABB& box, GameObject* object);
+	void DestroyProxy(int proxy);
+	void MoveProxy(int proxy, const AABB& box);
+	void FindPairs(std::vector<BroadphasePair>& pairs, JobSystem* jobs = nullptr);
+
+	// Sweep-and-prune has nothing to walk a ray through (the sorted lists only help with finding pairs), so every ray is tested against every box, 8 boxes
+	// at a time.
+	void CastRays(RayQuery& query) const;
+
+	int GetSweepAxis()
+	{
+		return sweepAxis;
+	}
+};
+
+#endif //_SWEEP_AND_PRUNE_H
@@ -0,0 +1,102 @@
+/*
+Title: AABB-3D
+File Name: TripleBuffer.h
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+This is an Axis-Aligned Bounding Box collision test. This is in 3D.
+Contains two cubes, one that is stationary and one that is moving. They are bounded
+by AABBs (Axis-Aligned Bounding Boxes) and when these AABBs collide, the moving
+object "bounces" on the X-axis (because that is the only direction the object is
+moving). The algorithm will detect collision along any axis, but will not be able
+to output the axis of collision because it doesn't know. Thus, we assume X and
+hardcode in the X-axis bounce. If you would like to know the axis of collision,
+try out the Swept AABB collision.
+There is a physics timestep such that every update runs at the same delta time,
+regardless of how fast or slow the computer is running. The cubes will not be the
+exact same as their AABBs, since they are rotating while the AABBs are aligned on
+the X-Y-Z axes but should you wish to see the AABBs match the cubes perfectly,
+simply comment out the rotate lines (obj1->Rotate, obj2->Rotate).
+*/
+
+#ifndef _TRIPLE_BUFFER_H
+#define _TRIPLE_BUFFER_H
+
+#include <atomic>
+
+// A lock-free way to hand data from one thread (the writer) to another (the reader).
+// There are three copies of the data. The writer always has one to itself to write into, the reader always has one to itself to read from, and the third one
+// sits in the middle. When the writer is done writing, it swaps its copy with the middle one. When the reader wants the newest data, it swaps its copy with
+// the middle one (but only if the writer has put something new there). Neither side ever waits on the other, and neither side ever sees a half written copy.
+// This only works with exactly one writer thread and one reader thread.
+template <typename T>
+class TripleBuffer
+{
+	// Set on the middle index when the writer has put new data there that the reader hasn't picked up yet.
+	static const int FRESH = 4;
+	static const int INDEX_MASK = 3;
+
+	T buffers[3];
+
+	std::atomic<int> middle;
+	int back;
+	int front;
+
+public:
+	TripleBuffer()
+	{
+		back = 0;
+		middle = 1;
+		front = 2;
+	}
+
+	// Writer side: the copy to write the next data into.
+	T& WriteBuffer()
+	{
+		return buffers[back];
+	}
+
+	// Writer side: hands the finished copy over to the reader.
+	void Publish()
+	{
+		back = middle.exchange(back | FRESH) & INDEX_MASK;
+	}
+
+	// Reader side: picks up the newest published copy, if there is one. Returns true if there was.
+	bool Update()
+	{
+		if (!(middle.load() & FRESH))
+		{
+			return false;
+		}
+
+		front = middle.exchange(front) & INDEX_MASK;
+		return true;
+	}
+
+	// Reader side: the newest copy picked up by Update.
+	const T& ReadBuffer() const
+	{
+		return buffers[front];
+	}
+};
+
+#endif //_TRIPLE_BUFFER_H
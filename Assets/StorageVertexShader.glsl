@@ -0,0 +1,61 @@
+/*
+Title: Physics Timestep
+File Name: StorageVertexShader.glsl
+Copyright  2015
+Original authors: Brockton Roth
+Written under the supervision of David I. Schwartz, Ph.D., and
+supported by a professional development seed grant from the B. Thomas
+Golisano College of Computing & Information Sciences
+(https://www.rit.edu/gccis) at the Rochester Institute of Technology.
+
+This program is free software: you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation, either version 3 of the License, or (at
+your option) any later version.
+
+This program is distributed in the hope that it will be useful, but
+WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+General Public License for more details.
+
+You should have received a copy of the GNU General Public License
+along with this program.  If not, see <http://www.gnu.org/licenses/>.
+
+Description:
+Builds upon the FPS project to introduce the concept of using a physics timestep.
+What this means is that every update will have a constant delta time that is set by
+a variable. This allows for smooth animations and deterministic physics. This particular
+project also implements an accumulator, which will take the delta time between the two
+frames and add it to a variable. That variable is then compared to the physics timestep,
+and we may end up calling the update function twice in a given frame. Even then, the
+delta time for the update function will always equal the physics timestep.
+*/
+
+#version 430 core // Identifies the version of the shader, this line must be on a separate line from the rest of the shader code
+ 
+layout(location = 0) in vec3 in_position;	// Get in a vec3 for position
+layout(location = 1) in vec4 in_color;		// Get in a vec4 for color
+
+out vec4 color; // Our vec4 color variable containing r, g, b, a
+
+// The camera's proj * view matrix, shared by every draw call this frame. This comes from a uniform buffer bound to binding point 0.
+layout(std140, binding = 0) uniform Camera
+{
+	mat4 PV;
+};
+
+// The transformation matrix of every object being drawn this frame, grouped by model. This comes from a shader storage buffer bound to binding point 1.
+layout(std430, binding = 1) readonly buffer Transforms
+{
+	mat4 models[];
+};
+
+uniform int firstObject; // Where this draw call's objects start in models
+
+// This is the same as VertexShader.glsl, except nothing gets uploaded per object. Each instance finds its own model matrix in the storage buffer using
+// gl_InstanceID, and multiplies it by PV here instead of on the CPU.
+void main(void)
+{
+	color = in_color;	// Pass the color through
+	gl_Position = PV * models[firstObject + gl_InstanceID] * vec4(in_position, 1.0); //w is 1.0, also notice cast to a vec4
+}
\ No newline at end of file